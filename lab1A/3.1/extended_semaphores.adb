@@ -0,0 +1,138 @@
+package body Extended_Semaphores is
+
+   use Counter_Exchange;
+   use Counter_Arithmetic;
+
+   protected body Gate is
+      entry Sleep (for N in 1 .. Max) when Owner.Count >= Counter (N) is
+      begin
+         null; -- the waiter takes the units with Try_Wait
+      end Sleep;
+
+      procedure Register is
+      begin
+         Owner.Waiters := Owner.Waiters + 1;
+         Contended := Contended + 1;
+         Max_Queue := Natural'Max (Max_Queue, Natural (Owner.Waiters));
+      end Register;
+
+      procedure Unregister (Waited : Time_Span; Success : Boolean) is
+      begin
+         Owner.Waiters := Owner.Waiters - 1;
+         Blocked := Blocked + Waited;
+         if not Success then
+            Timeouts := Timeouts + 1;
+         end if;
+      end Unregister;
+
+      procedure Wake is
+      begin
+         null; -- re-evaluates the Sleep barriers
+      end Wake;
+
+      function Read return Statistics is
+      begin
+         return (Acquisitions => Natural (Owner.Acquisitions),
+                 Contended    => Contended,
+                 Timeouts     => Timeouts,
+                 Max_Queue    => Max_Queue,
+                 Blocked      => Blocked);
+      end Read;
+   end Gate;
+
+   function Try_Wait (S : in out Semaphore; N : Positive := 1) return Boolean is
+      C : aliased Counter := S.Count;
+   begin
+      while C >= Counter (N) loop
+         -- A failed swap loads the current count into C
+         if Compare_And_Exchange (S.Count, C, C - Counter (N)) then
+            Atomic_Add (S.Acquisitions, 1);
+            return True;
+         end if;
+      end loop;
+      return False;
+   end Try_Wait;
+
+   -- Registering before Try_Wait and Signal_N adding before it reads
+   -- Waiters (both atomic) make sure that either the waiter sees the
+   -- units or the signaller sees the waiter and calls Wake.
+   procedure Block (S : in out Semaphore; N : Positive; Deadline : Time;
+                    Success : out Boolean) is
+      Start : constant Time := Clock;
+   begin
+      if N > S.Max then
+         raise Program_Error with "Wait above Max";
+      end if;
+      S.G.Register;
+      begin
+         loop
+            Success := Try_Wait (S, N);
+            exit when Success;
+            select
+               S.G.Sleep (N);
+            or
+               delay until Deadline;
+               exit;
+            end select;
+         end loop;
+      exception
+         when others =>
+            -- Do not leave Waiters counting a task that is gone
+            S.G.Unregister (Clock - Start, False);
+            raise;
+      end;
+      S.G.Unregister (Clock - Start, Success);
+   end Block;
+
+   procedure Wait_N (S : in out Semaphore; N : Positive) is
+      Success : Boolean;
+   begin
+      if not Try_Wait (S, N) then
+         Block (S, N, Time_Last, Success);
+      end if;
+   end Wait_N;
+
+   procedure Wait_N (S : in out Semaphore; N : Positive;
+                     Timeout : Time_Span; Success : out Boolean) is
+   begin
+      Success := Try_Wait (S, N);
+      if not Success then
+         Block (S, N, Clock + Timeout, Success);
+      end if;
+   end Wait_N;
+
+   procedure Wait (S : in out Semaphore) is
+   begin
+      Wait_N (S, 1);
+   end Wait;
+
+   procedure Wait (S : in out Semaphore; Timeout : Time_Span; Success : out Boolean) is
+   begin
+      Wait_N (S, 1, Timeout, Success);
+   end Wait;
+
+   procedure Signal_N (S : in out Semaphore; N : Positive) is
+      C : aliased Counter := S.Count;
+   begin
+      loop
+         if C + Counter (N) > Counter (S.Max) then
+            raise Program_Error with "Signal above Max";
+         end if;
+         exit when Compare_And_Exchange (S.Count, C, C + Counter (N));
+      end loop;
+      if S.Waiters > 0 then
+         S.G.Wake;
+      end if;
+   end Signal_N;
+
+   procedure Signal (S : in out Semaphore) is
+   begin
+      Signal_N (S, 1);
+   end Signal;
+
+   function Stats (S : Semaphore) return Statistics is
+   begin
+      return S.G.Read;
+   end Stats;
+
+end Extended_Semaphores;
@@ -1,18 +1,38 @@
 package body Buffer is
    protected body CircularBuffer is
 
-      entry Put(X: Item) when Count < Size is
+      entry Put(X: Item) when Count < Capacity is
       begin
          A(In_Ptr) := X;
-         In_Ptr := In_Ptr + 1;
+         In_Ptr := In_Ptr mod Capacity + 1;
          Count := Count + 1;
       end Put;
 
       entry Get(X: out Item) when Count > 0 is
       begin
          X := A(Out_Ptr);
-         Out_Ptr := Out_Ptr + 1;
+         Out_Ptr := Out_Ptr mod Capacity + 1;
          Count := Count - 1;
       end Get;
+
+      entry Put_Many(X: in Item_Batch; Last: out Natural) when Count < Capacity is
+      begin
+         Last := X'First + Integer'Min(X'Length, Capacity - Count) - 1;
+         for I in X'First..Last loop
+            A(In_Ptr) := X(I);
+            In_Ptr := In_Ptr mod Capacity + 1;
+         end loop;
+         Count := Count + (Last - X'First + 1);
+      end Put_Many;
+
+      entry Get_Many(X: out Item_Batch; Last: out Natural) when Count > 0 is
+      begin
+         Last := X'First + Integer'Min(X'Length, Count) - 1;
+         for I in X'First..Last loop
+            X(I) := A(Out_Ptr);
+            Out_Ptr := Out_Ptr mod Capacity + 1;
+         end loop;
+         Count := Count - (Last - X'First + 1);
+      end Get_Many;
    end CircularBuffer;
 end Buffer;
@@ -13,6 +13,7 @@ procedure ProducerConsumer_Prot is
 
    N : constant Integer := 10; -- Number of produced and consumed tokens per task
 	X : constant Integer := 3; -- Number of producers and consumers
+   Batch : constant Integer := 2; -- Items per Put_Many/Get_Many
 	
    -- Random Delays
    subtype Delay_Interval is Integer range 50..250;
@@ -27,15 +28,25 @@ procedure ProducerConsumer_Prot is
 
    task body Producer is
       Next : Time;
-			Value : Integer;
+      Values : Item_Batch(1..Batch);
+      Produced, First, Last, Count : Integer := 0;
    begin
       Next := Clock;
-      for I in 1..N loop
-						
-         -- ==> Complete code: Write to Buffer
-			   Value := Random(G);
-				 B.Put(Value);
-				 Put_Line("Producer " & Integer'Image(Id) & " Put :"&Integer'Image(Value));  
+      while Produced < N loop
+         Count := Integer'Min(Batch, N - Produced);
+         for I in 1..Count loop
+            Values(I) := Random(G);
+         end loop;
+         -- Write to Buffer, as much of the batch as fits per call
+         First := 1;
+         while First <= Count loop
+            B.Put_Many(Values(First..Count), Last);
+            for I in First..Last loop
+               Put_Line("Producer " & Integer'Image(Id) & " Put :"&Integer'Image(Values(I)));
+            end loop;
+            First := Last + 1;
+         end loop;
+         Produced := Produced + Count;
          -- Next 'Release' in 50..250ms
          Next := Next + Milliseconds(Random(G));
          delay until Next;
@@ -44,15 +55,17 @@ procedure ProducerConsumer_Prot is
 
    task body Consumer is
       Next : Time;
-      X : Integer;
+      Values : Item_Batch(1..Batch);
+      Consumed, Last : Integer := 0;
    begin
       Next := Clock;
-      for I in 1..N loop
-         -- Read from X
-				 B.Get(X);		
-         -- ==> Complete code: Read from Buffer
-			
-         Put_Line("Consumer " & Integer'Image(Id) & " Get :"&Integer'Image(X));
+      while Consumed < N loop
+         -- Read from Buffer, up to one batch
+         B.Get_Many(Values(1..Integer'Min(Batch, N - Consumed)), Last);
+         for I in 1..Last loop
+            Put_Line("Consumer " & Integer'Image(Id) & " Get :"&Integer'Image(Values(I)));
+         end loop;
+         Consumed := Consumed + Last;
          Next := Next + Milliseconds(Random(G));
          delay until Next;
       end loop;
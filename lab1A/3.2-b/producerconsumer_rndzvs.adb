@@ -6,71 +6,50 @@ use Ada.Real_Time;
 
 with Ada.Numerics.Discrete_Random;
 
+with Rndzvs_Buffer;
+
 procedure ProducerConsumer_Rndzvs is
 	
    N : constant Integer := 10; -- Number of produced and consumed tokens per task
 	X : constant Integer := 3; -- Number of producers and consumers	
+   Batch : constant Integer := 2; -- Items per Append_Many/Take_Many
 	
    -- Random Delays
    subtype Delay_Interval is Integer range 50..250;
    package Random_Delay is new Ada.Numerics.Discrete_Random (Delay_Interval);
    use Random_Delay;
    G : Generator;	
-   task Buffer is
-      entry Append(I : in Integer);
-      entry Take(I : out Integer);
-   end Buffer;
+
+   subtype Item_Batch is Rndzvs_Buffer.Item_Batch;
+
+   Buffer : Rndzvs_Buffer.Buffer;
 
    task type Producer(Id : Positive);
 
    task type Consumer(Id : Positive);
    
-   task body Buffer is
-         Size: constant Integer := 4;
-         type Index is mod Size;
-         type Item_Array is array(Index) of Integer;
-         B : Item_Array;
-         In_Ptr, Out_Ptr : Index := 0;
-				 Count: Integer range 0..Size := 0;
-   begin
-      loop
-         select
-				-- => Complete Code: Service Append
-				 when Count < Size =>
-							accept Append(I: in Integer) do
-											B(In_Ptr) := I;
-										  In_Ptr := In_Ptr + 1;
-						  				Count := Count + 1; 
-	    				end Append;
-				 or
-				-- => Complete Code: Service Take
-				 when Count > 0 =>
-							accept Take(I: out Integer) do
-											I := B(Out_Ptr);
-											Out_Ptr := Out_Ptr + 1;
-											Count := Count - 1;
-						  end Take;
-				 or
-				-- => Termination
-         terminate;
-
-				end select;
-      end loop;
-   end Buffer;
-      
    task body Producer is
       Next : Time;
-			Value : Integer;
+      Values : Item_Batch(1..Batch);
+      Produced, First, Last, Count : Integer := 0;
    begin
       Next := Clock;
-      for I in 1..N loop
-			
-         -- => Complete code: Write to X
-				Value := Random(G);	
-				Buffer.Append(Value);
-        Put_Line("Producer " & Integer'Image(Id) & " Put :"&Integer'Image(Value));  
-
-			 	-- Next 'Release' in 50..250ms
+      while Produced < N loop
+         Count := Integer'Min(Batch, N - Produced);
+         for I in 1..Count loop
+            Values(I) := Random(G);
+         end loop;
+         -- Write to Buffer, as much of the batch as fits per rendezvous
+         First := 1;
+         while First <= Count loop
+            Buffer.Append_Many(Values(First..Count), Last);
+            for I in First..Last loop
+               Put_Line("Producer " & Integer'Image(Id) & " Put :"&Integer'Image(Values(I)));
+            end loop;
+            First := Last + 1;
+         end loop;
+         Produced := Produced + Count;
+         -- Next 'Release' in 50..250ms
          Next := Next + Milliseconds(Random(G));
          delay until Next;
       end loop;
@@ -78,16 +57,19 @@ procedure ProducerConsumer_Rndzvs is
 
    task body Consumer is
       Next : Time;
-      X : Integer;
+      Values : Item_Batch(1..Batch);
+      Consumed, Last : Integer := 0;
    begin
       Next := Clock;
-      for I in 1..N loop
-         -- Complete Code: Read from X
-		     Buffer.Take(X);
+      while Consumed < N loop
+         -- Read from Buffer, up to one batch
+         Buffer.Take_Many(Values(1..Integer'Min(Batch, N - Consumed)), Last);
+         for I in 1..Last loop
+            Put_Line("Consumer " & Integer'Image(Id) & " Get :"&Integer'Image(Values(I)));
+         end loop;
+         Consumed := Consumed + Last;
          Next := Next + Milliseconds(Random(G));
-				 Put_Line("Consumer " & Integer'Image(Id) & " Get :"&Integer'Image(X));
-
-				 delay until Next;
+         delay until Next;
       end loop;
    end;
 	
@@ -0,0 +1,50 @@
+package body Rndzvs_Buffer is
+   task body Buffer is
+      B : array(1..Capacity) of Integer;
+      In_Ptr, Out_Ptr : Positive := 1;
+      Count: Integer range 0..Capacity := 0;
+   begin
+      loop
+         select
+            -- => Complete Code: Service Append
+            when Count < Capacity =>
+               accept Append(I: in Integer) do
+                  B(In_Ptr) := I;
+                  In_Ptr := In_Ptr mod Capacity + 1;
+                  Count := Count + 1;
+               end Append;
+         or
+            -- => Complete Code: Service Take
+            when Count > 0 =>
+               accept Take(I: out Integer) do
+                  I := B(Out_Ptr);
+                  Out_Ptr := Out_Ptr mod Capacity + 1;
+                  Count := Count - 1;
+               end Take;
+         or
+            when Count < Capacity =>
+               accept Append_Many(I: in Item_Batch; Last: out Natural) do
+                  Last := I'First + Integer'Min(I'Length, Capacity - Count) - 1;
+                  for J in I'First..Last loop
+                     B(In_Ptr) := I(J);
+                     In_Ptr := In_Ptr mod Capacity + 1;
+                  end loop;
+                  Count := Count + (Last - I'First + 1);
+               end Append_Many;
+         or
+            when Count > 0 =>
+               accept Take_Many(I: out Item_Batch; Last: out Natural) do
+                  Last := I'First + Integer'Min(I'Length, Count) - 1;
+                  for J in I'First..Last loop
+                     I(J) := B(Out_Ptr);
+                     Out_Ptr := Out_Ptr mod Capacity + 1;
+                  end loop;
+                  Count := Count - (Last - I'First + 1);
+               end Take_Many;
+         or
+            -- => Termination
+            terminate;
+         end select;
+      end loop;
+   end Buffer;
+end Rndzvs_Buffer;
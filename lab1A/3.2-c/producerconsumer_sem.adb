@@ -6,22 +6,20 @@ use Ada.Real_Time;
 
 with Ada.Numerics.Discrete_Random;
 
-with Semaphores;
-use Semaphores;
+with Extended_Semaphores;
+use Extended_Semaphores;
+
+with Sem_Buffer;
 
 procedure ProducerConsumer_Sem is
 	
 	N : constant Integer := 10; -- Number of produced and consumed tokens per task
 	X : constant Integer := 3; -- Number of producers and consumer
+	Batch : constant Integer := 2; -- Items per Put_Many/Get_Many
 		
-	-- Buffer Definition
-	Size: constant Integer := 4;
-	type Index is mod Size;
-	type Item_Array is array(Index) of Integer;
-	B : Item_Array;
-	In_Ptr, Out_Ptr : Index := 0;
-	Count : Integer range 0 .. Size := 0;
-
+	-- Buffer of 4 items with Put_Many/Get_Many and its semaphores
+	package Buffer is new Sem_Buffer (Size => 4);
+	use Buffer;
 
    -- Random Delays
    subtype Delay_Interval is Integer range 50..250;
@@ -29,14 +27,15 @@ procedure ProducerConsumer_Sem is
    use Random_Delay;
    G : Generator;
 	
-   -- => Complete code: Declation of Semaphores
-	--    1. Semaphore 'NotFull' to indicate that buffer is not full
-	--    2. Semaphore 'NotEmpty' to indicate that buffer is not empty
-	--    3. Semaphore 'AtomicAccess' to ensure an atomic access to the buffer
-
-   NotFull      : CountingSemaphore(Max => Size, Initial => Size);
-   NotEmpty     : CountingSemaphore(Max => Size, Initial => 0);
-   AtomicAccess : CountingSemaphore(Max => 1,    Initial => 1);
+   procedure Put_Stats(Name : String; S : Semaphore) is
+      T : constant Statistics := Stats(S);
+   begin
+      Put_Line(Name
+               & ": acquisitions" & Integer'Image(T.Acquisitions)
+               & ", contended" & Integer'Image(T.Contended)
+               & ", max queue" & Integer'Image(T.Max_Queue)
+               & ", blocked" & Duration'Image(To_Duration(T.Blocked)) & " s");
+   end Put_Stats;
 
 
    task type Producer(Id : Positive);
@@ -45,61 +44,58 @@ procedure ProducerConsumer_Sem is
 
    task body Producer is
       Next : Time;
-			Value : Integer;
+      Values : Item_Batch(1..Batch);
+      Produced, First, Last, N_Batch : Integer := 0;
    begin
       Next := Clock;
-      for I in 1..N loop
-         -- => Complete Code: Write to Buffer
-			Value := Random(G);
-			NotFull.Wait; 
-        		AtomicAccess.Wait; 
-
-			B(In_Ptr) := Value;
-      In_Ptr := In_Ptr + 1;
-      Count := Count + 1;
-      Put_Line("Producer " 
-      	      & Integer'Image(Id) 
-      	      & " put: " 
-      	      & Integer'Image(Value)
-      	      &" (Buffer count = " & Integer'Image(Count));
-
-
-				 AtomicAccess.Signal;
-         			 NotEmpty.Signal; 
+      while Produced < N loop
+         N_Batch := Integer'Min(Batch, N - Produced);
+         for I in 1..N_Batch loop
+            Values(I) := Random(G);
+         end loop;
+         -- => Write to Buffer, as much of the batch as fits per call
+         First := 1;
+         while First <= N_Batch loop
+            Put_Many(Values(First..N_Batch), Last);
+            for I in First..Last loop
+               Put_Line("Producer "
+                        & Integer'Image(Id)
+                        & " put: "
+                        & Integer'Image(Values(I)));
+            end loop;
+            First := Last + 1;
+         end loop;
+         Produced := Produced + N_Batch;
          -- Next 'Release' in 50..250ms
          Next := Next + Milliseconds(Random(G));
-         --delay until Next;
-				 delay until Next;
+         delay until Next;
       end loop;
    end;
 
    task body Consumer is
       Next : Time;
-		  X : Integer;
+      Values : Item_Batch(1..Batch);
+      Consumed, Last : Integer := 0;
    begin
       Next := Clock;
-      for I in 1..N loop
-         -- => Complete Code: Read from Buffer
-		     NotEmpty.Wait;      
-         AtomicAccess.Wait;
-
-         X := B(Out_Ptr);
-         Out_Ptr := Out_Ptr + 1;
-         Count := Count - 1;
-         Put_Line("Consumer " 
-         	 & Integer'Image(Id) 
-         	 & " got: " 
-         	 & Integer'Image(X)
-         	 &" (Buffer count = " & Integer'Image(Count));
-
-         AtomicAccess.Signal;
-         NotFull.Signal;
-			-- Next 'Release' in 50..250ms
+      while Consumed < N loop
+         -- => Read from Buffer, up to one batch
+         Get_Many(Values(1..Integer'Min(Batch, N - Consumed)), Last);
+         for I in 1..Last loop
+            Put_Line("Consumer "
+                     & Integer'Image(Id)
+                     & " got: "
+                     & Integer'Image(Values(I)));
+         end loop;
+         Consumed := Consumed + Last;
+         -- Next 'Release' in 50..250ms
          Next := Next + Milliseconds(Random(G));
          delay until Next;
       end loop;
    end;
 	
+begin -- main task
+   declare
 		 P1 : Producer(1);
 		 P2 : Producer(2);
 		 P3 : Producer(3);
@@ -107,9 +103,13 @@ procedure ProducerConsumer_Sem is
 		 C1 : Consumer(1);
 		 C2 : Consumer(2);
 		 C3 : Consumer(3);
-	
-begin -- main task
-   null;
+   begin
+      null; -- wait for all tasks
+   end;
+
+   Put_Stats("NotFull", NotFull);
+   Put_Stats("NotEmpty", NotEmpty);
+   Put_Stats("AtomicAccess", AtomicAccess);
 end ProducerConsumer_Sem;
 
 
@@ -0,0 +1,64 @@
+package body Sem_Buffer is
+
+   -- Buffer Definition
+   B : array(1..Size) of Integer;
+   In_Ptr, Out_Ptr : Positive := 1;
+   Count : Integer range 0 .. Size := 0;
+
+   procedure Put(X : in Integer) is
+   begin
+      Wait(NotFull);
+      Wait(AtomicAccess);
+      B(In_Ptr) := X;
+      In_Ptr := In_Ptr mod Size + 1;
+      Count := Count + 1;
+      Signal(AtomicAccess);
+      Signal(NotEmpty);
+   end Put;
+
+   procedure Get(X : out Integer) is
+   begin
+      Wait(NotEmpty);
+      Wait(AtomicAccess);
+      X := B(Out_Ptr);
+      Out_Ptr := Out_Ptr mod Size + 1;
+      Count := Count - 1;
+      Signal(AtomicAccess);
+      Signal(NotFull);
+   end Get;
+
+   procedure Put_Many(X : in Item_Batch; Last : out Natural) is
+   begin
+      Wait(NotFull);
+      Last := X'First;
+      while Last < X'Last and then Try_Wait(NotFull) loop
+         Last := Last + 1;
+      end loop;
+      Wait(AtomicAccess);
+      for I in X'First..Last loop
+         B(In_Ptr) := X(I);
+         In_Ptr := In_Ptr mod Size + 1;
+      end loop;
+      Count := Count + (Last - X'First + 1);
+      Signal(AtomicAccess);
+      Signal_N(NotEmpty, Last - X'First + 1);
+   end Put_Many;
+
+   procedure Get_Many(X : out Item_Batch; Last : out Natural) is
+   begin
+      Wait(NotEmpty);
+      Last := X'First;
+      while Last < X'Last and then Try_Wait(NotEmpty) loop
+         Last := Last + 1;
+      end loop;
+      Wait(AtomicAccess);
+      for I in X'First..Last loop
+         X(I) := B(Out_Ptr);
+         Out_Ptr := Out_Ptr mod Size + 1;
+      end loop;
+      Count := Count - (Last - X'First + 1);
+      Signal(AtomicAccess);
+      Signal_N(NotFull, Last - X'First + 1);
+   end Get_Many;
+
+end Sem_Buffer;
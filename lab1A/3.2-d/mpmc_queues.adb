@@ -0,0 +1,137 @@
+with Ada.Unchecked_Conversion;
+
+package body MPMC_Queues is
+
+   use Counter_Exchange;
+
+   type Difference is range -2**63 .. 2**63 - 1;
+   function To_Difference is new Ada.Unchecked_Conversion (Counter, Difference);
+
+   Size : constant Counter := Counter (Capacity);
+
+   -- The cell of the next position is free (Can_Put) or written (Can_Get)
+   function Can_Put (Q : Queue) return Boolean is
+      Pos  : constant Counter := Q.Enqueue.Value;
+      Slot : constant Natural := Natural (Pos mod Size);
+   begin
+      return Q.Cells (Slot).Turn + Counter (Slot) - Pos = 0;
+   end Can_Put;
+
+   function Can_Get (Q : Queue) return Boolean is
+      Pos  : constant Counter := Q.Dequeue.Value;
+      Slot : constant Natural := Natural (Pos mod Size);
+   begin
+      return Q.Cells (Slot).Turn + Counter (Slot) - (Pos + 1) = 0;
+   end Can_Get;
+
+   protected body Gate is
+      entry Sleep_Not_Full when Can_Put (Owner.all) is
+      begin
+         null; -- the waiter claims the cell with Try_Put
+      end Sleep_Not_Full;
+
+      entry Sleep_Not_Empty when Can_Get (Owner.all) is
+      begin
+         null;
+      end Sleep_Not_Empty;
+
+      procedure Register is
+      begin
+         Owner.Waiters := Owner.Waiters + 1;
+      end Register;
+
+      procedure Unregister is
+      begin
+         Owner.Waiters := Owner.Waiters - 1;
+      end Unregister;
+
+      procedure Wake is
+      begin
+         null; -- re-evaluates the barriers
+      end Wake;
+   end Gate;
+
+   function Try_Put (Q : in out Queue; X : Item) return Boolean is
+      Pos  : aliased Counter := Q.Enqueue.Value;
+      Slot : Natural;
+      Dif  : Difference;
+   begin
+      loop
+         Slot := Natural (Pos mod Size);
+         Dif := To_Difference (Q.Cells (Slot).Turn + Counter (Slot) - Pos);
+         if Dif = 0 then
+            -- Free for this position: claim it. A failed swap loads the
+            -- current position into Pos.
+            exit when Compare_And_Exchange (Q.Enqueue.Value, Pos, Pos + 1);
+         elsif Dif < 0 then
+            -- Still holds the item of the previous lap
+            return False;
+         else
+            Pos := Q.Enqueue.Value;
+         end if;
+      end loop;
+
+      Q.Cells (Slot).Data := X;
+      -- Atomic write: publishes Data to the consumer of Pos
+      Q.Cells (Slot).Turn := Pos + 1 - Counter (Slot);
+      if Q.Waiters > 0 then
+         Q.G.Wake;
+      end if;
+      return True;
+   end Try_Put;
+
+   function Try_Get (Q : in out Queue; X : out Item) return Boolean is
+      Pos  : aliased Counter := Q.Dequeue.Value;
+      Slot : Natural;
+      Dif  : Difference;
+   begin
+      loop
+         Slot := Natural (Pos mod Size);
+         Dif := To_Difference (Q.Cells (Slot).Turn + Counter (Slot) - (Pos + 1));
+         if Dif = 0 then
+            exit when Compare_And_Exchange (Q.Dequeue.Value, Pos, Pos + 1);
+         elsif Dif < 0 then
+            -- Not written yet for this position
+            return False;
+         else
+            Pos := Q.Dequeue.Value;
+         end if;
+      end loop;
+
+      X := Q.Cells (Slot).Data;
+      -- Free the cell for the producer one lap later
+      Q.Cells (Slot).Turn := Pos + Size - Counter (Slot);
+      if Q.Waiters > 0 then
+         Q.G.Wake;
+      end if;
+      return True;
+   end Try_Get;
+
+   -- Registering before the retry and Try_Get/Try_Put reading Waiters
+   -- after the cell is written (both atomic) make sure that either the
+   -- retry succeeds or the other task sees the waiter and calls Wake.
+   procedure Put (Q : in out Queue; X : Item) is
+   begin
+      if Try_Put (Q, X) then
+         return;
+      end if;
+      Q.G.Register;
+      while not Try_Put (Q, X) loop
+         Q.G.Sleep_Not_Full;
+      end loop;
+      Q.G.Unregister;
+   end Put;
+
+   procedure Get (Q : in out Queue; X : out Item) is
+   begin
+      if Try_Get (Q, X) then
+         return;
+      end if;
+      Q.G.Register;
+      while not Try_Get (Q, X) loop
+         Q.G.Sleep_Not_Empty;
+      end loop;
+      Q.G.Unregister;
+   end Get;
+
+end MPMC_Queues;
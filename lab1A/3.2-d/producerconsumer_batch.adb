@@ -0,0 +1,191 @@
+-- Throughput and latency of Put_Many/Get_Many for batch sizes 1 to 32 on
+-- the protected, rendezvous and semaphore buffers, with 4 producers and
+-- 4 consumers and no delay between the operations. The buffers are the
+-- units of 3.2-a..c (Buffer, Rndzvs_Buffer, Sem_Buffer) with Size = 32
+-- items, so that a batch is not cut by a full buffer. Latency is the
+-- time from before Put_Many of an item to after the Get_Many that
+-- returns it.
+--
+-- Build: gnatmake -gnat2022 -I../3.1 -I../3.2-a -I../3.2-b -I../3.2-c
+-- Usage: producerconsumer_batch [items per producer]
+
+with Ada.Text_IO;
+use Ada.Text_IO;
+
+with Ada.Real_Time;
+use Ada.Real_Time;
+
+with Ada.Command_Line;
+
+with Buffer;
+with Rndzvs_Buffer;
+with Sem_Buffer;
+
+procedure ProducerConsumer_Batch is
+
+   Tasks : constant Integer := 4; -- Number of producers and consumers
+   Size  : constant Integer := 32;
+
+   type Size_List is array (Positive range <>) of Positive;
+   Batches : constant Size_List := (1, 2, 4, 8, 16, 32);
+
+   Items : Positive := 20_000; -- Items per producer
+
+   -- Put time of every item, the item is its index
+   type Time_Array is array (Positive range <>) of Time;
+   type Time_Access is access Time_Array;
+   Put_Time : Time_Access;
+
+   protected Stats is
+      procedure Add (Sum, Max : Time_Span);
+      procedure Reset;
+      procedure Read (Sum, Max : out Time_Span);
+   private
+      Total, Worst : Time_Span := Time_Span_Zero;
+   end Stats;
+
+   protected body Stats is
+      procedure Add (Sum, Max : Time_Span) is
+      begin
+         Total := Total + Sum;
+         if Max > Worst then
+            Worst := Max;
+         end if;
+      end Add;
+
+      procedure Reset is
+      begin
+         Total := Time_Span_Zero;
+         Worst := Time_Span_Zero;
+      end Reset;
+
+      procedure Read (Sum, Max : out Time_Span) is
+      begin
+         Sum := Total;
+         Max := Worst;
+      end Read;
+   end Stats;
+
+   -- The buffers of 3.2-a, 3.2-b and 3.2-c, with Size items
+   Prot_Buffer : Buffer.CircularBuffer(Size);
+   Rndzvs : Rndzvs_Buffer.Buffer(Size);
+   package Sem is new Sem_Buffer(Size);
+
+   generic
+      type Item_Batch is array (Positive range <>) of Integer;
+      with procedure Put_Many (X : in Item_Batch; Last : out Natural);
+      with procedure Get_Many (X : out Item_Batch; Last : out Natural);
+   procedure Run (Batch : Positive);
+
+   procedure Run (Batch : Positive) is
+      Start   : Time;
+      Elapsed : Duration;
+      Sum, Max : Time_Span;
+   begin
+      Stats.Reset;
+      Start := Clock;
+      declare
+         task type Producer(Id : Positive);
+         task type Consumer;
+
+         task body Producer is
+            Values : Item_Batch(1..Batch);
+            Produced, First, Last, Count : Integer := 0;
+         begin
+            while Produced < Items loop
+               Count := Integer'Min(Batch, Items - Produced);
+               for I in 1..Count loop
+                  Values(I) := (Id - 1) * Items + Produced + I;
+               end loop;
+               First := 1;
+               while First <= Count loop
+                  Put_Time(Values(First)) := Clock;
+                  for I in First + 1..Count loop
+                     Put_Time(Values(I)) := Put_Time(Values(First));
+                  end loop;
+                  Put_Many(Values(First..Count), Last);
+                  First := Last + 1;
+               end loop;
+               Produced := Produced + Count;
+            end loop;
+         end;
+
+         task body Consumer is
+            Values : Item_Batch(1..Batch);
+            Consumed, Last : Integer := 0;
+            Now : Time;
+            Sum, Max, Latency : Time_Span := Time_Span_Zero;
+         begin
+            while Consumed < Items loop
+               Get_Many(Values(1..Integer'Min(Batch, Items - Consumed)), Last);
+               Now := Clock;
+               for I in 1..Last loop
+                  Latency := Now - Put_Time(Values(I));
+                  Sum := Sum + Latency;
+                  if Latency > Max then
+                     Max := Latency;
+                  end if;
+               end loop;
+               Consumed := Consumed + Last;
+            end loop;
+            Stats.Add(Sum, Max);
+         end;
+
+         type Producer_Access is access Producer;
+         P : array (1..Tasks) of Producer_Access;
+         C : array (1..Tasks) of Consumer;
+      begin
+         for I in P'Range loop
+            P(I) := new Producer(I);
+         end loop;
+      end;
+      Elapsed := To_Duration (Clock - Start);
+
+      Stats.Read(Sum, Max);
+      Put_Line(Integer'Image(Batch) & ASCII.HT
+               & Integer'Image(Integer(Long_Float(Tasks * Items) / Long_Float(Elapsed)))
+               & ASCII.HT
+               & Duration'Image(To_Duration(Sum) / (Tasks * Items) * 1_000_000)
+               & ASCII.HT
+               & Duration'Image(To_Duration(Max) * 1_000_000));
+   end Run;
+
+   procedure Run_Prot is
+     new Run (Buffer.Item_Batch, Prot_Buffer.Put_Many, Prot_Buffer.Get_Many);
+   procedure Run_Rndzvs is
+     new Run (Rndzvs_Buffer.Item_Batch, Rndzvs.Append_Many, Rndzvs.Take_Many);
+   procedure Run_Sem is
+     new Run (Sem.Item_Batch, Sem.Put_Many, Sem.Get_Many);
+
+   procedure Header (Name : String) is
+   begin
+      New_Line;
+      Put_Line(Name);
+      Put_Line("Batch" & ASCII.HT & "items/s" & ASCII.HT
+               & "mean latency (us)" & ASCII.HT & "max latency (us)");
+   end;
+
+begin -- main task
+   if Ada.Command_Line.Argument_Count > 0 then
+      Items := Positive'Value (Ada.Command_Line.Argument (1));
+   end if;
+   Put_Time := new Time_Array (1 .. Tasks * Items);
+
+   Put_Line(Integer'Image(Tasks) & " producers," & Integer'Image(Tasks)
+            & " consumers," & Integer'Image(Items) & " items per producer");
+
+   Header("Protected object");
+   for B of Batches loop
+      Run_Prot(B);
+   end loop;
+
+   Header("Rendezvous");
+   for B of Batches loop
+      Run_Rndzvs(B);
+   end loop;
+
+   Header("Semaphores");
+   for B of Batches loop
+      Run_Sem(B);
+   end loop;
+end ProducerConsumer_Batch;
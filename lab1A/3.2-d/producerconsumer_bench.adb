@@ -0,0 +1,186 @@
+-- Throughput of the producer-consumer buffers with 1 to 16 producers and
+-- as many consumers: the units of 3.2-a..c (Buffer, Rndzvs_Buffer,
+-- Sem_Buffer on the extended semaphores of 3.1) and the lock-free queue.
+-- All buffers hold Buffer.Size items and there is no delay between the
+-- operations.
+--
+-- Build: gnatmake -gnat2022 -I../3.1 -I../3.2-a -I../3.2-b -I../3.2-c
+-- Usage: producerconsumer_bench [items per producer]
+
+with Ada.Text_IO;
+use Ada.Text_IO;
+
+with Ada.Real_Time;
+use Ada.Real_Time;
+
+with Ada.Command_Line;
+
+with Buffer;
+with Rndzvs_Buffer;
+with Sem_Buffer;
+with Extended_Semaphores;
+with MPMC_Queues;
+
+procedure ProducerConsumer_Bench is
+
+   type Count_List is array (Positive range <>) of Positive;
+   Counts : constant Count_List := (1, 2, 4, 8, 16);
+
+   Items : Positive := 100_000; -- Items per producer
+
+   Size : constant Integer := Buffer.Size;
+
+   -- Sum of all items received, to check that none is lost or doubled
+   protected Total is
+      procedure Add (S : Long_Long_Integer);
+      procedure Reset;
+      function Value return Long_Long_Integer;
+   private
+      Sum : Long_Long_Integer := 0;
+   end Total;
+
+   protected body Total is
+      procedure Add (S : Long_Long_Integer) is
+      begin
+         Sum := Sum + S;
+      end Add;
+
+      procedure Reset is
+      begin
+         Sum := 0;
+      end Reset;
+
+      function Value return Long_Long_Integer is
+      begin
+         return Sum;
+      end Value;
+   end Total;
+
+   -- The buffers of 3.2-a, 3.2-b and 3.2-c, with Size items
+   B : Buffer.CircularBuffer(Size);
+   Rndzvs : Rndzvs_Buffer.Buffer(Size);
+   package Sem is new Sem_Buffer(Size);
+
+   procedure Prot_Put (X : Integer) is
+   begin
+      B.Put(X);
+   end;
+
+   procedure Prot_Get (X : out Integer) is
+   begin
+      B.Get(X);
+   end;
+
+   procedure Rndzvs_Put (X : Integer) is
+   begin
+      Rndzvs.Append(X);
+   end;
+
+   procedure Rndzvs_Get (X : out Integer) is
+   begin
+      Rndzvs.Take(X);
+   end;
+
+   -- Lock-free
+   package Integer_Queues is new MPMC_Queues (Item => Integer, Capacity => Size);
+   Q : Integer_Queues.Queue;
+
+   procedure LockFree_Put (X : Integer) is
+   begin
+      Integer_Queues.Put(Q, X);
+   end;
+
+   procedure LockFree_Get (X : out Integer) is
+   begin
+      Integer_Queues.Get(Q, X);
+   end;
+
+   -- Items per second with Tasks producers and Tasks consumers
+   generic
+      with procedure Put (X : Integer);
+      with procedure Get (X : out Integer);
+   function Run (Tasks : Positive) return Long_Float;
+
+   function Run (Tasks : Positive) return Long_Float is
+      Start   : Time;
+      Elapsed : Duration;
+      Expected : constant Long_Long_Integer :=
+        Long_Long_Integer (Tasks) * Long_Long_Integer (Items)
+        * (Long_Long_Integer (Items) + 1) / 2;
+   begin
+      Total.Reset;
+      Start := Clock;
+      declare
+         task type Producer;
+         task type Consumer;
+
+         task body Producer is
+         begin
+            for I in 1..Items loop
+               Put(I);
+            end loop;
+         end;
+
+         task body Consumer is
+            X : Integer;
+            Sum : Long_Long_Integer := 0;
+         begin
+            for I in 1..Items loop
+               Get(X);
+               Sum := Sum + Long_Long_Integer (X);
+            end loop;
+            Total.Add(Sum);
+         end;
+
+         P : array (1..Tasks) of Producer;
+         C : array (1..Tasks) of Consumer;
+      begin
+         null; -- wait for all tasks
+      end;
+      Elapsed := To_Duration (Clock - Start);
+
+      if Total.Value /= Expected then
+         Put_Line("Checksum error: " & Long_Long_Integer'Image(Total.Value)
+                  & " /= " & Long_Long_Integer'Image(Expected));
+      end if;
+      return Long_Float (Tasks) * Long_Float (Items) / Long_Float (Elapsed);
+   end Run;
+
+   function Run_Prot is new Run (Prot_Put, Prot_Get);
+   function Run_Rndzvs is new Run (Rndzvs_Put, Rndzvs_Get);
+   function Run_Sem is new Run (Sem.Put, Sem.Get);
+   function Run_LockFree is new Run (LockFree_Put, LockFree_Get);
+
+   procedure Put_Column (Rate : Long_Float) is
+      Image : constant String := Integer'Image (Integer (Rate));
+   begin
+      Put((1 .. 14 - Image'Length => ' ') & Image);
+   end;
+
+begin -- main task
+   if Ada.Command_Line.Argument_Count > 0 then
+      Items := Positive'Value (Ada.Command_Line.Argument (1));
+   end if;
+
+   Put_Line("Items per producer:" & Integer'Image(Items)
+            & ", buffer size:" & Integer'Image(Size));
+   Put_Line("Tasks     protected    rendezvous    semaphores     lock-free  (items/s)");
+   for T of Counts loop
+      Put(Integer'Image(T) & (1 .. 6 - Integer'Image(T)'Length => ' '));
+      Put_Column(Run_Prot(T));
+      Put_Column(Run_Rndzvs(T));
+      Put_Column(Run_Sem(T));
+      Put_Column(Run_LockFree(T));
+      New_Line;
+   end loop;
+
+   declare
+      T : constant Extended_Semaphores.Statistics :=
+        Extended_Semaphores.Stats(Sem.AtomicAccess);
+   begin
+      Put_Line("AtomicAccess: acquisitions" & Integer'Image(T.Acquisitions)
+               & ", contended" & Integer'Image(T.Contended)
+               & ", max queue" & Integer'Image(T.Max_Queue)
+               & ", blocked" & Duration'Image(To_Duration(T.Blocked)) & " s");
+   end;
+end ProducerConsumer_Bench;
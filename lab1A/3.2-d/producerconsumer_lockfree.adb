@@ -0,0 +1,67 @@
+with Ada.Text_IO;
+use Ada.Text_IO;
+
+with Ada.Real_Time;
+use Ada.Real_Time;
+
+with MPMC_Queues;
+
+with Ada.Numerics.Discrete_Random;
+
+procedure ProducerConsumer_LockFree is
+
+   N : constant Integer := 10; -- Number of produced and consumed tokens per task
+   X : constant Integer := 3; -- Number of producers and consumers
+
+   -- Random Delays
+   subtype Delay_Interval is Integer range 50..250;
+   package Random_Delay is new Ada.Numerics.Discrete_Random (Delay_Interval);
+   use Random_Delay;
+   G : Generator;
+
+   -- Same size as Buffer.CircularBuffer
+   package Integer_Queues is new MPMC_Queues (Item => Integer, Capacity => 3);
+   B : Integer_Queues.Queue;
+
+   task type Producer(Id : Positive);
+   task type Consumer(Id : Positive);
+
+   task body Producer is
+      Next : Time;
+      Value : Integer;
+   begin
+      Next := Clock;
+      for I in 1..N loop
+         Value := Random(G);
+         Integer_Queues.Put(B, Value);
+         Put_Line("Producer " & Integer'Image(Id) & " Put :"&Integer'Image(Value));
+         -- Next 'Release' in 50..250ms
+         Next := Next + Milliseconds(Random(G));
+         delay until Next;
+      end loop;
+   end;
+
+   task body Consumer is
+      Next : Time;
+      X : Integer;
+   begin
+      Next := Clock;
+      for I in 1..N loop
+         Integer_Queues.Get(B, X);
+         Put_Line("Consumer " & Integer'Image(Id) & " Get :"&Integer'Image(X));
+         Next := Next + Milliseconds(Random(G));
+         delay until Next;
+      end loop;
+   end;
+
+   P1 : Producer(1);
+   P2 : Producer(2);
+   P3 : Producer(3);
+
+   C1 : Consumer(1);
+   C2 : Consumer(2);
+   C3 : Consumer(3);
+
+begin -- main task
+   null;
+end ProducerConsumer_LockFree;
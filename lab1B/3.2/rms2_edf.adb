@@ -0,0 +1,11 @@
+pragma Task_Dispatching_Policy(EDF_Across_Priorities);
+
+with Workload;
+with Workload.EDF;
+pragma Unreferenced (Workload.EDF);
+
+-- Task set of rms2 (rms2.cfg) under EDF, per-job results in rms2_edf.csv
+procedure rms2_edf is
+begin
+   Workload.Experiment("rms2.cfg", "rms2_edf.csv", EDF => True);
+end rms2_edf;
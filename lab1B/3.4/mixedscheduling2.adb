@@ -1,110 +1,15 @@
 pragma Priority_Specific_Dispatching(FIFO_Within_Priorities, 2, 50);
 pragma Priority_Specific_Dispatching(Round_Robin_Within_Priorities, 1, 1);
 
-
-
-with Ada.Text_IO; use Ada.Text_IO;
-with Ada.Float_Text_IO;
 with Ada.Real_Time; use Ada.Real_Time;
 
-procedure mixedscheduling2 is
-	package Duration_IO is new Ada.Text_IO.Fixed_IO(Duration);
-	package Int_IO is new Ada.Text_IO.Integer_IO(Integer);
-
-	Start : Time; -- Start Time of the System
-	Calibrator: constant Integer := 1214; -- Calibration for correct timing
-	                                     -- ==> Change parameter for your architecture!
-	Warm_Up_Time: constant Integer := 100; -- Warmup time in milliseconds
-	
-	-- Conversion Function: Time_Span to Float
-	function To_Float(TS : Time_Span) return Float is
-        SC : Seconds_Count;
-        Frac : Time_Span;
-	begin
-		Split(Time_Of(0, TS), SC, Frac);
-		return Float(SC) + Time_Unit * Float(Frac/Time_Span_Unit);
-	end To_Float;
-	
-	-- Function F is a dummy function that is used to model a running user program.
-	function F(N : Integer) return Integer;
-	function F(N : Integer) return Integer is
-		X : Integer := 0;
-	begin
-		for Index in 1..N loop
-			for I in 1..500 loop
-				X := X + I;
-			end loop;
-		end loop;
-		return X;
-	end F;
-	
-	-- Workload Model for a Parametric Task
-	task type T(Id: Integer; Prio: Integer; Phase: Integer; Period : Integer; 
-		Computation_Time : Integer; Relative_Deadline: Integer) is
-		pragma Priority(Prio); -- A higher number gives a higher priority
-	end;
-
-	task body T is
-		Next : Time;
-		Release: Time;
-		Completed : Time;
-		Response : Time_Span;
-		Average_Response : Float;
-		Absolute_Deadline: Time;
-		WCRT: Time_Span; -- measured WCRT (Worst Case Response Time)
-		Dummy : Integer;
-		Iterations : Integer;
-	begin
-		-- Initial Release - Phase
-		Release := Clock + Milliseconds(Phase);
-		delay until Release;
-		Next := Release;
-		Iterations := 0;
-		Average_Response := 0.0;
-		WCRT := Milliseconds(0);
-		loop
-			Next := Release + Milliseconds(Period);
-			Absolute_Deadline := Release + Milliseconds(Relative_Deadline);
-
-			-- Simulation of User Function
-			for I in 1..Computation_Time loop
-				Dummy := F(Calibrator); 
-			end loop;	
+with Workload;
+with Workload.Round_Robin; -- quantum of the background tasks
+pragma Unreferenced (Workload.Round_Robin);
 
-			Completed := Clock;
-			Response := Completed - Release;
-			Average_Response := (Float(Iterations) * Average_Response + To_Float(Response)) / Float(Iterations + 1);
-			if Response > WCRT then
-				WCRT := Response;
-			end if;
-
-			Iterations := Iterations + 1;			
-			Put("Task ");
-			Int_IO.Put(Id, 1);
-			Put("- Release: ");
-			Duration_IO.Put(To_Duration(Release - Start), 2, 3);
-			Put(", Completion: ");
-			Duration_IO.Put(To_Duration(Completed - Start), 2, 3);
-			Put(", Response: ");
-			Duration_IO.Put(To_Duration(Response), 1, 3);
-			Put(", WCRT: ");
-			Ada.Float_Text_IO.Put(To_Float(WCRT), fore => 1, aft => 3, exp => 0);	
-			Put(", Next Release: ");
-			Duration_IO.Put(To_Duration(Next - Start), 2, 3);
-
-			if Completed > Absolute_Deadline then 
-				Put(" ==> Task ");
-				Int_IO.Put(Id, 1);
-				Put(" violates Deadline!");
-			end if;
-
-			Put_Line("");
-			Release := Next;
-
-
-			delay until Release;
-		end loop;
-	end T;
+-- Task set in mixedscheduling2.cfg, per-job results and watchdog events
+-- in mixedscheduling2.csv (see ../common/workload.ads)
+procedure mixedscheduling2 is
 
 	-- =======================================================================
 	-- Acts similar to a normal tasks that should iterate on 
@@ -118,18 +23,18 @@ procedure mixedscheduling2 is
 	end;
 	-- =======================================================================
 	task body Watchdog is
-		Next 	: Time;
+		Epoch, Finish : Time;
 		Release : Time;
 		Phase	: Integer := 100;
 		Period  : Integer := 1200;
 	begin
+		Workload.Await_Start(Epoch, Finish);
 		-- intial phase (100ms)
-		Release := Clock + Milliseconds(Phase);
+		Release := Epoch + Milliseconds(Phase);
 		delay until Release;
 		
-		loop
-			Next := Release + Milliseconds(Period);
-			Release := Next;
+		while Release < Finish loop
+			Release := Release + Milliseconds(Period);
 			
 			-- Rendezvous for serving request made by helper.
 			-- Select -> Request
@@ -139,63 +44,40 @@ procedure mixedscheduling2 is
 					-- Reset recieved, do nothing...
 					-- By this entry being called and instantly finishing
 					-- we go through the loop again which updates the period.
-					Put_Line("-- Watchdog Reset... --");
+					Workload.Event(Workload.Reset);
 				end ResetTimer;
 			or
 				-- Timeout:
 				-- Alert, then wait for next period.
 				delay until Release;
-				Put_Line("-- Watchdog Timeout... --");
+				Workload.Event(Workload.Overload);
 			end select;
 		end loop;
 	end Watchdog;
 
 	task body HelperTask is
-		Next 	: Time;
+		Epoch, Finish : Time;
 		Release : Time;
 		Phase	: Integer := 100;
 		Period  : Integer := 1200;
 	begin
+		Workload.Await_Start(Epoch, Finish);
 		-- initial phase (100ms)
-		Release := Clock + Milliseconds(Phase);
+		Release := Epoch + Milliseconds(Phase);
 		delay until Release;
-		loop
-			Next := Release + Milliseconds(Period);
-			Release := Next;
+		while Release < Finish loop
+			Release := Release + Milliseconds(Period);
 
 			-- Call Watchdog to Reset Timer.
 			Watchdog.ResetTimer;
 
 			delay until Release;
 		end loop;
+	exception
+		when Tasking_Error => null; -- Watchdog ended the run first
 	end HelperTask;
 	-- =======================================================================
 	
-
-	-- Running Tasks
-	-- NOTE: All tasks should have a minimum phase, so that they have the same time base!
-	
-	-- Task_1 : T(1, 20, Warm_Up_Time, 2000, 1000, 2000); -- ID: 1
-	                                                   -- Priority: 20
-                                                      --	Phase: Warm_Up_Time (100)
-	                                                   -- Period 2000, 
-	                                                   -- Computation Time: 1000 (if correctly calibrated) 
-	                                                   -- Relative Deadline: 2000
-	-- =======================================================================
-	-- Taskset in 3.2.3
-	Task_1 : T(1, 4, Warm_Up_Time, 300, 100, 300);
-	Task_2 : T(2, 3, Warm_Up_Time, 400, 100, 400);
-	Task_3 : T(3, 2, Warm_Up_Time, 600, 100, 600);
-	-- Task_4 : T(4, 1, Warm_Up_Time, 1200, 200, 1200);
-
-   Task_background_5 : T(5, 1, Warm_Up_Time, 1200, 100, 1200);
-	Task_background_6 : T(6, 1, Warm_Up_Time, 1200, 100, 1200);
-	Task_background_7 : T(7, 1, Warm_Up_Time, 1200, 100, 1200);
-	
-	-- =======================================================================
-	
--- Main Program: Terminates after measuring start time	
 begin
-	Start := Clock; -- Central Start Time
-	null;
+	Workload.Experiment("mixedscheduling2.cfg", "mixedscheduling2.csv");
 end mixedscheduling2;
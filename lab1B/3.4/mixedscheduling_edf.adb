@@ -0,0 +1,14 @@
+pragma Task_Dispatching_Policy(EDF_Across_Priorities);
+
+with Workload;
+with Workload.EDF;
+pragma Unreferenced (Workload.EDF);
+with Overload_Watch; -- helper and watchdog tasks
+pragma Unreferenced (Overload_Watch);
+
+-- Task set of mixedscheduling (mixedscheduling.cfg) under EDF, per-job
+-- results and watchdog events in mixedscheduling_edf.csv
+procedure mixedscheduling_edf is
+begin
+   Workload.Experiment("mixedscheduling.cfg", "mixedscheduling_edf.csv", EDF => True);
+end mixedscheduling_edf;
@@ -0,0 +1,68 @@
+with Ada.Real_Time; use Ada.Real_Time;
+
+with Buffer;use Buffer;
+
+with Workload;
+
+package body Overload_Watch is
+
+   B : Buffer.Watchdog_PO; -- Watchdog Object from Buffer Package 
+
+   -- Helper Task
+   task type Helper(Prio: Integer; Phase: Integer; Period : Integer) is
+      pragma Priority(Prio); -- A higher number gives a higher priority
+   end;
+
+   task body Helper is
+      Epoch, Finish, Next : Time;
+   begin
+      Workload.Await_Start(Epoch, Finish);
+      Next := Epoch + Milliseconds(Phase);
+      Workload.Delay_Until(Next, Milliseconds(Period));
+      while Next < Finish loop
+         Next := Next + Milliseconds(Period);
+
+      -- Feed the dog
+         B.Feed;
+         Workload.Event(Workload.Fed);
+
+         Workload.Delay_Until(Next, Milliseconds(Period));
+      end loop;
+   end Helper;
+
+
+   -- Watchdog Task
+   task type Watchdog(Prio: Integer; Phase: Integer; Period : Integer) is
+      pragma Priority(Prio); -- A higher number gives a higher priority
+   end;
+
+   task body Watchdog is
+      Epoch, Finish, Next : Time;
+   begin
+      Workload.Await_Start(Epoch, Finish);
+      Next := Epoch + Milliseconds(Phase);
+      Workload.Delay_Until(Next, Milliseconds(Period));
+      while Next < Finish loop
+         Next := Next + Milliseconds(Period);
+
+      -- Check the dog
+         if not B.Is_Fed then
+            Workload.Event(Workload.Overload);
+         else
+            B.Reset;
+         end if;
+
+         Workload.Delay_Until(Next, Milliseconds(Period));
+      end loop;
+   end Watchdog;
+
+
+   Task_Helper  : Helper(4, 100, 1200); -- Priority: 4
+                                        -- Phase: Warm_Up_Time (100)
+                                        -- Period: 1200
+
+   Task_Watchdog: Watchdog(50, 1300, 1200); -- Priority: 50
+                                            -- Phase: finish the first hyperperiod
+                                            -- Period: 1200                                                    
+
+end Overload_Watch;
@@ -0,0 +1,13 @@
+with System.Multiprocessors; use System.Multiprocessors;
+with System.Multiprocessors.Dispatching_Domains;
+
+package body Workload.Affinity is
+
+   procedure Pin (CPU : Positive) is
+   begin
+      Dispatching_Domains.Set_CPU(CPU_Range(CPU));
+   end Pin;
+
+begin
+   Set_CPU := Pin'Access;
+end Workload.Affinity;
@@ -0,0 +1,95 @@
+with Ada.Dynamic_Priorities;
+with Ada.Execution_Time.Timers; use Ada.Execution_Time.Timers;
+with Ada.Task_Identification; use Ada.Task_Identification;
+with Ada.Unchecked_Deallocation;
+with System;
+
+package body Workload.Budgets is
+
+   -- Budget timer of one task. The handler runs when the job has used
+   -- its budget: it demotes the task, or opens Expired to abort the job.
+   protected type Budget_Control is
+      pragma Interrupt_Priority (Min_Handler_Ceiling);
+      procedure Arm (Id : Task_Id; Action : Overrun_Action);
+      procedure Handler (TM : in out Timer);
+      entry Expired;
+      procedure Clear (Fired : out Boolean);
+   private
+      Owner : Task_Id;
+      On_Overrun : Overrun_Action := Demote;
+      Has_Fired : Boolean := False;
+   end Budget_Control;
+
+   protected body Budget_Control is
+      procedure Arm (Id : Task_Id; Action : Overrun_Action) is
+      begin
+         Owner := Id;
+         On_Overrun := Action;
+         Has_Fired := False;
+      end Arm;
+
+      procedure Handler (TM : in out Timer) is
+      begin
+         Has_Fired := True;
+         if On_Overrun = Demote then
+            Ada.Dynamic_Priorities.Set_Priority(System.Priority'First, Owner);
+         end if;
+      end Handler;
+
+      entry Expired when Has_Fired is
+      begin
+         null;
+      end Expired;
+
+      procedure Clear (Fired : out Boolean) is
+      begin
+         Fired := Has_Fired;
+         Has_Fired := False;
+      end Clear;
+   end Budget_Control;
+
+   type Timer_Access is access Timer;
+   procedure Free is new Ada.Unchecked_Deallocation (Timer, Timer_Access);
+
+   -- Per task index; a new task of the next Run arms them again
+   Controls : array (1 .. Max_Tasks) of Budget_Control;
+   Owners   : array (1 .. Max_Tasks) of aliased Task_Id := (others => Null_Task_Id);
+   Timers   : array (1 .. Max_Tasks) of Timer_Access;
+
+   procedure Run_Job (Index   : Positive;
+                      P       : Task_Params;
+                      Action  : Overrun_Action;
+                      Job     : not null access procedure;
+                      Overrun : out Boolean) is
+      Control : Budget_Control renames Controls(Index);
+      Cancelled : Boolean;
+   begin
+      if Owners(Index) /= Current_Task then
+         -- First job of the task of a new Run
+         Free(Timers(Index));
+         Owners(Index) := Current_Task;
+         Timers(Index) := new Timer(Owners(Index)'Access);
+         Control.Arm(Owners(Index), Action);
+      end if;
+      Set_Handler(Timers(Index).all, Milliseconds(P.Budget), Control.Handler'Access);
+      if Action = Abort_Job then
+         select
+            Control.Expired;
+         then abort
+            Job.all;
+         end select;
+      else
+         Job.all;
+      end if;
+      Cancel_Handler(Timers(Index).all, Cancelled);
+      Control.Clear(Overrun);
+      -- Back to its priority before it waits for the next release, not
+      -- after: released at the lowest priority it might never run again
+      if Overrun and Action = Demote then
+         Ada.Dynamic_Priorities.Set_Priority(P.Priority);
+      end if;
+   end Run_Job;
+
+begin
+   Budget_Job := Run_Job'Access;
+end Workload.Budgets;
@@ -0,0 +1,18 @@
+with Ada.Dispatching.EDF;
+
+package body Workload.EDF is
+
+   procedure Delay_Until_And_Set_Deadline (Release : Time; Deadline : Time_Span) is
+   begin
+      Ada.Dispatching.EDF.Delay_Until_And_Set_Deadline(Release, Deadline);
+   end Delay_Until_And_Set_Deadline;
+
+   procedure Set_Deadline (Deadline : Time) is
+   begin
+      Ada.Dispatching.EDF.Set_Deadline(Deadline);
+   end Set_Deadline;
+
+begin
+   EDF_Delay := Delay_Until_And_Set_Deadline'Access;
+   EDF_Deadline := Set_Deadline'Access;
+end Workload.EDF;
@@ -0,0 +1,16 @@
+with Ada.Dispatching.Round_Robin;
+
+package body Workload.Round_Robin is
+
+   procedure Set (Priority : Integer; Quantum : Time_Span) is
+   begin
+      if not Ada.Dispatching.Round_Robin.Is_Round_Robin(Priority) then
+         raise Config_Error with "quantum: priority" & Integer'Image(Priority)
+                                 & " is not round-robin";
+      end if;
+      Ada.Dispatching.Round_Robin.Set_Quantum(Priority, Quantum);
+   end Set;
+
+begin
+   Set_Quantum := Set'Access;
+end Workload.Round_Robin;
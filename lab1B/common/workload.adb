@@ -0,0 +1,1044 @@
+with Ada.Text_IO; use Ada.Text_IO;
+with Ada.Integer_Text_IO;
+with Ada.Float_Text_IO;
+with Ada.Strings.Fixed; use Ada.Strings.Fixed;
+with Ada.Strings;
+with Ada.Command_Line;
+with Ada.Execution_Time; use type Ada.Execution_Time.CPU_Time;
+with System.Multiprocessors; use System.Multiprocessors;
+with Ada.Unchecked_Deallocation;
+
+package body Workload is
+
+   Max_Events : constant := 1024;
+   Max_Trace_Events : constant := 4096; -- per task
+
+   Per_Ms : Positive := 1; -- Calibration
+   -- Modular, so that F can run for any N without overflow (the 50 ms of
+   -- Calibrate take tens of thousands of iterations)
+   type Word is mod 2**32;
+   Sink : Word with Volatile; -- keeps F from being optimised away
+
+   type Job is record
+      Release, Completion : Time;
+      Overrun : Boolean;
+   end record;
+
+   type Job_Array is array (Positive range <>) of Job;
+
+   type Job_Log (Size : Natural) is record
+      Count : Natural := 0;
+      Jobs  : Job_Array (1 .. Size);
+   end record;
+
+   type Job_Log_Access is access Job_Log;
+   procedure Free is new Ada.Unchecked_Deallocation (Job_Log, Job_Log_Access);
+
+   -- Timeline of one task for Write_Trace. Limited, so that it is passed
+   -- by reference also into an aborted Compute.
+   type Trace_Kind is (Released, Started, Preempted, Resumed, Finished);
+
+   type Trace_Event is record
+      Kind : Trace_Kind;
+      At_Time : Time;
+   end record;
+
+   type Trace_Event_Array is array (Positive range <>) of Trace_Event;
+
+   type Trace_Log (Size : Natural) is limited record
+      Count   : Natural := 0;
+      Dropped : Natural := 0;
+      Events  : Trace_Event_Array (1 .. Size);
+   end record;
+
+   type Trace_Log_Access is access Trace_Log;
+   procedure Free is new Ada.Unchecked_Deallocation (Trace_Log, Trace_Log_Access);
+
+   -- The task set of the last Run. Each task only writes its own log;
+   -- they are read after the tasks have terminated.
+   Params     : Task_Array (1 .. Max_Tasks);
+   Task_Count : Natural := 0;
+   Logs       : array (1 .. Max_Tasks) of Job_Log_Access;
+   Traces     : array (1 .. Max_Tasks) of Trace_Log_Access;
+   Epoch      : Time;
+   Use_EDF    : Boolean := False;
+   On_Overrun : Overrun_Action := Demote;
+   Placement  : Placement_Kind := Global;
+   CPU_Count  : Positive := 1;
+
+   -- Background tasks, each written by its own task only
+   type Work_Count is record
+      Units, Switches : Natural := 0;
+   end record;
+
+   Work : array (1 .. Max_Tasks) of Work_Count;
+   -- Processor time of each task over the run, written by the task
+   Busy : array (1 .. Max_Tasks) of Time_Span;
+   Run_Length : Positive := 1;
+   Slice : Positive := 1; -- units of a background task between two deadlines
+
+   type Event_Record is record
+      Kind : Event_Kind;
+      At_Time : Time;
+   end record;
+
+   type Event_Array is array (1 .. Max_Events) of Event_Record;
+
+   protected Events is
+      procedure Add (Kind : Event_Kind);
+      function Count return Natural;
+      function Get (I : Positive) return Event_Record;
+   private
+      List : Event_Array;
+      N    : Natural := 0;
+   end Events;
+
+   protected body Events is
+      procedure Add (Kind : Event_Kind) is
+      begin
+         if N < Max_Events then
+            N := N + 1;
+            List(N) := (Kind, Clock);
+         end if;
+      end Add;
+
+      function Count return Natural is
+      begin
+         return N;
+      end Count;
+
+      function Get (I : Positive) return Event_Record is
+      begin
+         return List(I);
+      end Get;
+   end Events;
+
+   protected Start is
+      procedure Open (E, F : Time);
+      procedure Abandon;
+      entry Wait (E, F : out Time);
+   private
+      Is_Open : Boolean := False;
+      Epoch_Time, Finish_Time : Time;
+   end Start;
+
+   protected body Start is
+      procedure Open (E, F : Time) is
+      begin
+         Epoch_Time := E;
+         Finish_Time := F;
+         Is_Open := True;
+      end Open;
+
+      -- No run: an empty one long ago, so that the waiting tasks skip
+      -- their phase and loop and terminate
+      procedure Abandon is
+      begin
+         if not Is_Open then
+            Open(Time_First, Time_First);
+         end if;
+      end Abandon;
+
+      entry Wait (E, F : out Time) when Is_Open is
+      begin
+         E := Epoch_Time;
+         F := Finish_Time;
+      end Wait;
+   end Start;
+
+	-- Function F is a dummy function that is used to model a running user program.
+   function F(N : Integer) return Word is
+      X : Word := 0;
+   begin
+      for Index in 1..N loop
+         for I in Word range 1..500 loop
+            X := X + I;
+         end loop;
+      end loop;
+      return X;
+   end F;
+
+   function Calibration return Positive is
+   begin
+      return Per_Ms;
+   end Calibration;
+
+   procedure Compute (Ms : Natural) is
+   begin
+      for I in 1..Ms loop
+         Sink := F(Per_Ms);
+      end loop;
+   end Compute;
+
+   procedure Add (Trace : in out Trace_Log; Kind : Trace_Kind; At_Time : Time) is
+   begin
+      if Trace.Count < Trace.Size then
+         Trace.Count := Trace.Count + 1;
+         Trace.Events(Trace.Count) := (Kind, At_Time);
+      else
+         Trace.Dropped := Trace.Dropped + 1;
+      end if;
+   end Add;
+
+   -- Compute of a traced task. The clock is read after every unit: a gap
+   -- longer than two units means the task was preempted, which is
+   -- traced from the end of the last unit to the start of this one.
+   procedure Compute (Ms : Natural; Trace : in out Trace_Log) is
+      Last : Time := Clock;
+      Now : Time;
+   begin
+      for I in 1..Ms loop
+         Sink := F(Per_Ms);
+         Now := Clock;
+         if Now - Last > Milliseconds(2) then
+            Add(Trace, Preempted, Last);
+            Add(Trace, Resumed, Now - Milliseconds(1));
+         end if;
+         Last := Now;
+      end loop;
+   end Compute;
+
+   -- Doubles N until F(N) takes 50 ms, then keeps the fastest of three
+   -- runs (the least disturbed).
+   procedure Calibrate is
+      N : Positive := 64;
+      T0 : Time;
+      Elapsed, Best : Time_Span;
+   begin
+      loop
+         T0 := Clock;
+         Sink := F(N);
+         Elapsed := Clock - T0;
+         exit when Elapsed >= Milliseconds(50);
+         N := N * 2;
+      end loop;
+      Best := Elapsed;
+      for I in 1..2 loop
+         T0 := Clock;
+         Sink := F(N);
+         Elapsed := Clock - T0;
+         if Elapsed < Best then
+            Best := Elapsed;
+         end if;
+      end loop;
+      Per_Ms := Positive'Max(1, Integer(Float(N) / (Float(To_Duration(Best)) * 1000.0)));
+   end Calibrate;
+
+   function Load (File_Name : String) return Task_Set is
+      File : File_Type;
+      Set : Task_Set (Max_Tasks);
+      Count : Natural := 0;
+      Line_No : Natural := 0;
+
+      procedure Fail (Message : String) is
+      begin
+         raise Config_Error with File_Name & ":" & Trim(Natural'Image(Line_No), Ada.Strings.Left)
+                                 & ": " & Message;
+      end Fail;
+
+      procedure Parse (Line : String) is
+         Values : array (1..8) of Integer := (others => 0);
+         Last : Natural := Line'First - 1;
+      begin
+         if Index(Line, "duration") = Index_Non_Blank(Line) then
+            Ada.Integer_Text_IO.Get(Line(Index(Line, "duration") + 8 .. Line'Last), Values(1), Last);
+            Set.Length := Values(1);
+            return;
+         end if;
+         if Index(Line, "background") = Index_Non_Blank(Line) then
+            Last := Index(Line, "background") + 9;
+            for I in 1..3 loop
+               Ada.Integer_Text_IO.Get(Line(Last + 1 .. Line'Last), Values(I), Last);
+            end loop;
+            if Index_Non_Blank(Line(Last + 1 .. Line'Last)) /= 0 then
+               Ada.Integer_Text_IO.Get(Line(Last + 1 .. Line'Last), Values(8), Last);
+            end if;
+            if Count = Max_Tasks then
+               Fail("more than" & Integer'Image(Max_Tasks) & " tasks");
+            end if;
+            Count := Count + 1;
+            Set.Tasks(Count) := (Id => Values(1), Priority => Values(2), Phase => Values(3),
+                                 Period => Set.Length, Computation_Time => 0,
+                                 Relative_Deadline => Set.Length, Budget => 0,
+                                 CPU => Values(8), Background => True);
+            return;
+         end if;
+         if Index(Line, "quantum") = Index_Non_Blank(Line) then
+            Last := Index(Line, "quantum") + 6;
+            while Index_Non_Blank(Line(Last + 1 .. Line'Last)) /= 0 loop
+               if Set.Quantum_Count = Max_Quanta then
+                  Fail("more than" & Integer'Image(Max_Quanta) & " quanta");
+               end if;
+               Set.Quantum_Count := Set.Quantum_Count + 1;
+               Ada.Integer_Text_IO.Get(Line(Last + 1 .. Line'Last), Values(1), Last);
+               Set.Quanta(Set.Quantum_Count) := Values(1);
+            end loop;
+            return;
+         end if;
+         if Index(Line, "cpus") = Index_Non_Blank(Line) then
+            Ada.Integer_Text_IO.Get(Line(Index(Line, "cpus") + 4 .. Line'Last), Values(1), Last);
+            Set.CPUs := Values(1);
+            return;
+         end if;
+         if Index(Line, "placement") = Index_Non_Blank(Line) then
+            if Index(Line, "global") /= 0 then
+               Set.Placement := Global;
+            elsif Index(Line, "manual") /= 0 then
+               Set.Placement := Manual;
+            elsif Index(Line, "first-fit") /= 0 then
+               Set.Placement := First_Fit;
+            elsif Index(Line, "worst-fit") /= 0 then
+               Set.Placement := Worst_Fit;
+            else
+               Fail("expected 'placement global|manual|first-fit|worst-fit'");
+            end if;
+            return;
+         end if;
+         if Index(Line, "overrun") = Index_Non_Blank(Line) then
+            if Index(Line, "abort") /= 0 then
+               Set.Overrun := Abort_Job;
+            elsif Index(Line, "demote") /= 0 then
+               Set.Overrun := Demote;
+            else
+               Fail("expected 'overrun demote' or 'overrun abort'");
+            end if;
+            return;
+         end if;
+         for I in 1..6 loop
+            Ada.Integer_Text_IO.Get(Line(Last + 1 .. Line'Last), Values(I), Last);
+         end loop;
+         -- Optional budget and CPU
+         for I in 7..8 loop
+            exit when Index_Non_Blank(Line(Last + 1 .. Line'Last)) = 0;
+            Ada.Integer_Text_IO.Get(Line(Last + 1 .. Line'Last), Values(I), Last);
+         end loop;
+         if Count = Max_Tasks then
+            Fail("more than" & Integer'Image(Max_Tasks) & " tasks");
+         end if;
+         Count := Count + 1;
+         Set.Tasks(Count) := (Id => Values(1), Priority => Values(2), Phase => Values(3),
+                              Period => Values(4), Computation_Time => Values(5),
+                              Relative_Deadline => Values(6), Budget => Values(7),
+                              CPU => Values(8), Background => False);
+      end Parse;
+
+   begin
+      Set.Length := 10_000;
+      Open(File, In_File, File_Name);
+      while not End_Of_File(File) loop
+         declare
+            Line : constant String := Get_Line(File);
+            Comment : constant Natural := Index(Line, "#");
+            Text : constant String :=
+              (if Comment = 0 then Line else Line(Line'First .. Comment - 1));
+         begin
+            Line_No := Line_No + 1;
+            if Index_Non_Blank(Text) /= 0 then
+               Parse(Text);
+            end if;
+         exception
+            when Config_Error => raise;
+            when others => Fail("expected a keyword line or six to eight integers");
+         end;
+      end loop;
+      Close(File);
+      return (Count => Count, Length => Set.Length, Overrun => Set.Overrun,
+              Placement => Set.Placement, CPUs => Set.CPUs,
+              Quanta => Set.Quanta, Quantum_Count => Set.Quantum_Count,
+              Tasks => Set.Tasks(1..Count));
+   exception
+      when Name_Error =>
+         raise Config_Error with "cannot open " & File_Name;
+   end Load;
+
+   function Utilisation (Tasks : Task_Array) return Float is
+      U : Float := 0.0;
+   begin
+      for P of Tasks loop
+         U := U + Float(P.Computation_Time) / Float(P.Period);
+      end loop;
+      return U;
+   end Utilisation;
+
+   function Utilisation (Set : Task_Set) return Float is
+   begin
+      return Utilisation(Set.Tasks);
+   end Utilisation;
+
+   function Utilisation (P : Task_Params) return Float is
+     (Float(P.Computation_Time) / Float(P.Period));
+
+   procedure Place (Set : in out Task_Set) is
+      CPUs : constant Positive :=
+        (if Set.CPUs = 0 then Positive(Number_Of_CPUs) else Set.CPUs);
+      Load : array (1..CPUs) of Float := (others => 0.0);
+      Order : array (1..Set.Count) of Positive;
+      Next, Best : Natural;
+   begin
+      if CPUs > Positive(Number_Of_CPUs) then
+         raise Config_Error with "cpus" & Integer'Image(CPUs) & " but only"
+                                 & CPU'Image(Number_Of_CPUs) & " CPUs";
+      end if;
+
+      case Set.Placement is
+         when Global =>
+            -- No CPU is set, so the run can use every CPU of the process
+            if CPUs < Positive(Number_Of_CPUs) then
+               raise Config_Error with "cpus" & Integer'Image(CPUs)
+                 & " is not enforced by placement global, limit the CPUs with taskset";
+            end if;
+            for P of Set.Tasks loop
+               P.CPU := 0;
+            end loop;
+
+         when Manual =>
+            for P of Set.Tasks loop
+               if P.CPU > CPUs then
+                  raise Config_Error with "task" & Integer'Image(P.Id) & " on CPU"
+                                          & Integer'Image(P.CPU) & " of" & Integer'Image(CPUs);
+               end if;
+            end loop;
+
+         when First_Fit | Worst_Fit =>
+            -- Decreasing utilisation (insertion sort)
+            for I in Order'Range loop
+               Next := I;
+               while Next > 1 and then Utilisation(Set.Tasks(Order(Next - 1)))
+                                       < Utilisation(Set.Tasks(I)) loop
+                  Order(Next) := Order(Next - 1);
+                  Next := Next - 1;
+               end loop;
+               Order(Next) := I;
+            end loop;
+
+            for K of Order loop
+               Best := 0;
+               for C in Load'Range loop
+                  if Set.Placement = First_Fit then
+                     if Load(C) + Utilisation(Set.Tasks(K)) <= 1.0 then
+                        Best := C;
+                        exit;
+                     end if;
+                  elsif Best = 0 or else Load(C) < Load(Best) then
+                     Best := C;
+                  end if;
+               end loop;
+               if Best = 0 then
+                  -- Fits nowhere: least loaded CPU
+                  Best := 1;
+                  for C in Load'Range loop
+                     if Load(C) < Load(Best) then
+                        Best := C;
+                     end if;
+                  end loop;
+               end if;
+               Set.Tasks(K).CPU := Best;
+               Load(Best) := Load(Best) + Utilisation(Set.Tasks(K));
+            end loop;
+      end case;
+   end Place;
+
+   procedure Delay_Until (Release : Time; Deadline : Time_Span) is
+   begin
+      if Use_EDF then
+         EDF_Delay(Release, Deadline);
+      else
+         delay until Release;
+      end if;
+   end Delay_Until;
+
+   procedure Run (Set : Task_Set; EDF : Boolean := False) is
+      Placed : Task_Set := Set;
+      Finish : Time;
+   begin
+      if Set.Count > Max_Tasks then
+         raise Config_Error with "more than" & Integer'Image(Max_Tasks) & " tasks";
+      end if;
+      Place(Placed);
+      if EDF and EDF_Delay = null then
+         raise Config_Error with "EDF needs Workload.EDF in the main program";
+      end if;
+      if Set_CPU = null and then (for some P of Placed.Tasks => P.CPU /= 0) then
+         raise Config_Error with "placement needs Workload.Affinity in the main program";
+      end if;
+      if (for some P of Set.Tasks => P.Budget > 0) then
+         if Budget_Job = null then
+            raise Config_Error with "budgets need Workload.Budgets in the main program";
+         elsif EDF and Set.Overrun = Demote then
+            raise Config_Error with "overrun demote has no effect under EDF, use overrun abort";
+         end if;
+      end if;
+      if Set.Quantum_Count > 0 and not EDF and Set_Quantum = null then
+         raise Config_Error with "quantum needs Workload.Round_Robin in the main program";
+      end if;
+      Task_Count := Set.Count;
+      Params(1..Task_Count) := Placed.Tasks;
+      Placement := Set.Placement;
+      CPU_Count := (if Set.CPUs = 0 then Positive(Number_Of_CPUs) else Set.CPUs);
+      Run_Length := Set.Length;
+      Slice := Set.Quanta(1);
+      Work := (others => (0, 0));
+      Busy := (others => Time_Span_Zero);
+
+      if Set.Quantum_Count > 0 and not EDF then
+         for P of Set.Tasks loop
+            if P.Background then
+               Set_Quantum(P.Priority, Milliseconds(Set.Quanta(1)));
+            end if;
+         end loop;
+      end if;
+      for I in 1..Task_Count loop
+         Free(Logs(I));
+         Logs(I) := new Job_Log(Set.Length / Params(I).Period + 1);
+         Free(Traces(I));
+         Traces(I) := new Trace_Log(Max_Trace_Events);
+      end loop;
+      Use_EDF := EDF;
+      On_Overrun := Set.Overrun;
+
+      Epoch := Clock;
+      Finish := Epoch + Milliseconds(Set.Length);
+      Start.Open(Epoch, Finish);
+
+      declare
+         -- Workload Model for a Parametric Task
+         task type T(Index: Positive; Prio: Integer) is
+            pragma Priority(Prio); -- A higher number gives a higher priority
+         end;
+
+         task body T is
+            P : Task_Params renames Params(Index);
+            Log : Job_Log renames Logs(Index).all;
+            Trace : Trace_Log renames Traces(Index).all;
+            Release : Time := Epoch + Milliseconds(P.Phase);
+            Overrun : Boolean := False;
+            CPU_Start : constant Ada.Execution_Time.CPU_Time :=
+              Ada.Execution_Time.Clock;
+
+            procedure Compute_Job is
+            begin
+               Compute(P.Computation_Time, Trace);
+            end Compute_Job;
+         begin
+            if P.CPU /= 0 then
+               Set_CPU(P.CPU);
+            end if;
+            if P.Background then
+               -- Work units until the end of the run
+               declare
+                  W : Work_Count renames Work(Index);
+                  Last, Now : Time;
+                  -- Under EDF: later than the deadline of every periodic
+                  -- job, which is at most Finish + Length
+                  Far : constant Time_Span := Milliseconds(2 * Run_Length);
+               begin
+                  Delay_Until(Release, Far);
+                  Last := Clock;
+                  Add(Trace, Started, Last);
+                  while Last < Finish loop
+                     Compute(1);
+                     Now := Clock;
+                     W.Units := W.Units + 1;
+                     if Now - Last > Milliseconds(2) then
+                        W.Switches := W.Switches + 1;
+                        Add(Trace, Preempted, Last);
+                        Add(Trace, Resumed, Now - Milliseconds(1));
+                     end if;
+                     Last := Now;
+                     -- Under EDF a new deadline after each slice puts the
+                     -- task behind the other background tasks, as the
+                     -- round-robin quantum does
+                     if Use_EDF and then W.Units mod Slice = 0 then
+                        EDF_Deadline(Now + Far);
+                     end if;
+                  end loop;
+                  Add(Trace, Finished, Last);
+               end;
+            end if;
+            while not P.Background and Release < Finish and Log.Count < Log.Size loop
+               Delay_Until(Release, Milliseconds(P.Relative_Deadline));
+               Add(Trace, Released, Release);
+               Add(Trace, Started, Clock);
+               if P.Budget = 0 then
+                  Compute_Job;
+               else
+                  Budget_Job(Index, P, On_Overrun, Compute_Job'Access, Overrun);
+               end if;
+               Log.Count := Log.Count + 1;
+               Log.Jobs(Log.Count) := (Release, Clock, Overrun);
+               Add(Trace, Finished, Log.Jobs(Log.Count).Completion);
+               Release := Release + Milliseconds(P.Period);
+            end loop;
+            Busy(Index) := Ada.Execution_Time.Clock - CPU_Start;
+         end T;
+
+         type T_Access is access T;
+         Tasks : array (1..Task_Count) of T_Access;
+      begin
+         for I in Tasks'Range loop
+            Tasks(I) := new T(I, Params(I).Priority);
+         end loop;
+      end; -- waits for the tasks
+   end Run;
+
+   procedure Await_Start (Epoch, Finish : out Time) is
+   begin
+      Start.Wait(Epoch, Finish);
+   end Await_Start;
+
+   procedure Event (Kind : Event_Kind) is
+   begin
+      Events.Add(Kind);
+   end Event;
+
+   function Image (D : Duration) return String is
+   begin
+      return Trim(Duration'Image(D), Ada.Strings.Left);
+   end Image;
+
+   function Image (I : Integer) return String is
+   begin
+      return Trim(Integer'Image(I), Ada.Strings.Left);
+   end Image;
+
+   function Missed (P : Task_Params; J : Job) return Boolean is
+   begin
+      return J.Completion > J.Release + Milliseconds(P.Relative_Deadline);
+   end Missed;
+
+   function Misses (I : Positive) return Natural is
+      N : Natural := 0;
+   begin
+      for J of Logs(I).Jobs(1..Logs(I).Count) loop
+         if Missed(Params(I), J) then
+            N := N + 1;
+         end if;
+      end loop;
+      return N;
+   end Misses;
+
+   function Overruns (I : Positive) return Natural is
+      N : Natural := 0;
+   begin
+      for J of Logs(I).Jobs(1..Logs(I).Count) loop
+         if J.Overrun then
+            N := N + 1;
+         end if;
+      end loop;
+      return N;
+   end Overruns;
+
+   function Misses return Natural is
+      N : Natural := 0;
+   begin
+      for I in 1..Task_Count loop
+         N := N + Misses(I);
+      end loop;
+      return N;
+   end Misses;
+
+   function WCRT (I : Positive) return Time_Span is
+      W : Time_Span := Time_Span_Zero;
+   begin
+      for J of Logs(I).Jobs(1..Logs(I).Count) loop
+         if J.Completion - J.Release > W then
+            W := J.Completion - J.Release;
+         end if;
+      end loop;
+      return W;
+   end WCRT;
+
+   function Background_Count return Natural is
+      N : Natural := 0;
+   begin
+      for I in 1..Task_Count loop
+         if Params(I).Background then
+            N := N + 1;
+         end if;
+      end loop;
+      return N;
+   end Background_Count;
+
+   -- Work units of all background tasks per second of the run
+   function Throughput return Float is
+      Units : Natural := 0;
+   begin
+      for I in 1..Task_Count loop
+         if Params(I).Background then
+            Units := Units + Work(I).Units;
+         end if;
+      end loop;
+      return Float(Units) * 1000.0 / Float(Run_Length);
+   end Throughput;
+
+   -- Jain's index of the work units: 1 when all background tasks did the
+   -- same work, 1/n when one task did all of it
+   function Fairness return Float is
+      Sum, Squares : Float := 0.0;
+   begin
+      for I in 1..Task_Count loop
+         if Params(I).Background then
+            Sum := Sum + Float(Work(I).Units);
+            Squares := Squares + Float(Work(I).Units) ** 2;
+         end if;
+      end loop;
+      if Squares = 0.0 then
+         return 0.0;
+      end if;
+      return Sum ** 2 / (Float(Background_Count) * Squares);
+   end Fairness;
+
+   function Switch_Rate return Float is
+      Switches : Natural := 0;
+   begin
+      for I in 1..Task_Count loop
+         if Params(I).Background then
+            Switches := Switches + Work(I).Switches;
+         end if;
+      end loop;
+      return Float(Switches) * 1000.0 / Float(Run_Length);
+   end Switch_Rate;
+
+   -- Measured utilisation of task I: its processor time over the run
+   function Busy_Share (I : Positive) return Float is
+     (Float(To_Duration(Busy(I))) * 1000.0 / Float(Run_Length));
+
+   procedure Put_Summary is
+      Total, Worst : Time_Span;
+      U, Declared : Float;
+      N : Natural;
+      Pinned : Boolean;
+   begin
+      Put_Line("Calibration:" & Integer'Image(Per_Ms) & " iterations of F per ms");
+      Put("Dispatching: " & (if Use_EDF then "EDF" else "fixed priority"));
+      Put(", utilisation: ");
+      Ada.Float_Text_IO.Put(Utilisation(Params(1..Task_Count)),
+                            Fore => 1, Aft => 3, Exp => 0);
+      Put(", placement: " & Placement_Kind'Image(Placement) & " on"
+          & Integer'Image(CPU_Count) & " CPUs");
+      New_Line;
+      for I in 1..Task_Count loop
+         if Params(I).Background then
+            Put("Background task ");
+            Ada.Integer_Text_IO.Put(Params(I).Id, 1);
+            Put(" - Work units:" & Integer'Image(Work(I).Units));
+            Put_Line(", Context switches:" & Integer'Image(Work(I).Switches));
+         else
+            Total := Time_Span_Zero;
+            for J of Logs(I).Jobs(1..Logs(I).Count) loop
+               Total := Total + (J.Completion - J.Release);
+            end loop;
+            Put("Task ");
+            Ada.Integer_Text_IO.Put(Params(I).Id, 1);
+            if Params(I).CPU /= 0 then
+               Put(" (CPU" & Integer'Image(Params(I).CPU) & ")");
+            end if;
+            Put(" - Jobs:" & Integer'Image(Logs(I).Count));
+            Put(", Deadline misses:" & Integer'Image(Misses(I)));
+            if Params(I).Budget > 0 then
+               Put(", Budget overruns:" & Integer'Image(Overruns(I)));
+            end if;
+            Put(", WCRT: ");
+            Ada.Float_Text_IO.Put(Float(To_Duration(WCRT(I))), Fore => 1, Aft => 3, Exp => 0);
+            Put(", Average response: ");
+            if Logs(I).Count > 0 then
+               Ada.Float_Text_IO.Put(Float(To_Duration(Total)) / Float(Logs(I).Count),
+                                     Fore => 1, Aft => 3, Exp => 0);
+            end if;
+            New_Line;
+         end if;
+      end loop;
+      -- Partitioned: per CPU, the measured utilisation (processor time of
+      -- its tasks over the run) and the declared one. A global run has no
+      -- per-CPU report, its tasks migrate: only the measured total over
+      -- all CPUs.
+      for C in 1..CPU_Count loop
+         U := 0.0;
+         Declared := 0.0;
+         N := 0;
+         Worst := Time_Span_Zero;
+         Pinned := False;
+         for I in 1..Task_Count loop
+            if Params(I).CPU = C then
+               Pinned := True;
+               U := U + Busy_Share(I);
+               Declared := Declared + Utilisation(Params(I));
+               N := N + Misses(I);
+               if WCRT(I) > Worst then
+                  Worst := WCRT(I);
+               end if;
+            end if;
+         end loop;
+         if Pinned then
+            Put("CPU" & Integer'Image(C) & " - Utilisation: ");
+            Ada.Float_Text_IO.Put(U, Fore => 1, Aft => 3, Exp => 0);
+            Put(" (declared ");
+            Ada.Float_Text_IO.Put(Declared, Fore => 1, Aft => 3, Exp => 0);
+            Put("), Deadline misses:" & Integer'Image(N) & ", WCRT: ");
+            Ada.Float_Text_IO.Put(Float(To_Duration(Worst)), Fore => 1, Aft => 3, Exp => 0);
+            New_Line;
+         end if;
+      end loop;
+      if Placement = Global then
+         U := 0.0;
+         for I in 1..Task_Count loop
+            U := U + Busy_Share(I);
+         end loop;
+         Put("All CPUs - Utilisation: ");
+         Ada.Float_Text_IO.Put(U / Float(CPU_Count), Fore => 1, Aft => 3, Exp => 0);
+         Put_Line(" per CPU");
+      end if;
+      if Background_Count > 0 then
+         Put("Background - Throughput: ");
+         Ada.Float_Text_IO.Put(Throughput, Fore => 1, Aft => 1, Exp => 0);
+         Put(" units/s, Jain's index: ");
+         Ada.Float_Text_IO.Put(Fairness, Fore => 1, Aft => 3, Exp => 0);
+         Put(", Context switches/s: ");
+         Ada.Float_Text_IO.Put(Switch_Rate, Fore => 1, Aft => 1, Exp => 0);
+         New_Line;
+      end if;
+      for I in 1..Events.Count loop
+         if Events.Get(I).Kind = Overload then
+            Put_Line("Overload detected at " & Image(To_Duration(Events.Get(I).At_Time - Epoch)));
+         end if;
+      end loop;
+   end Put_Summary;
+
+   procedure Write_CSV (File_Name : String) is
+      File : File_Type;
+   begin
+      Create(File, Out_File, File_Name);
+      Put_Line(File, "task,job,release,completion,response,missed,overrun");
+      for I in 1..Task_Count loop
+         for N in 1..Logs(I).Count loop
+            declare
+               J : Job renames Logs(I).Jobs(N);
+            begin
+               Put_Line(File, Image(Params(I).Id) & "," & Image(N)
+                        & "," & Image(To_Duration(J.Release - Epoch))
+                        & "," & Image(To_Duration(J.Completion - Epoch))
+                        & "," & Image(To_Duration(J.Completion - J.Release))
+                        & "," & (if Missed(Params(I), J) then "1" else "0")
+                        & "," & (if J.Overrun then "1" else "0"));
+            end;
+         end loop;
+      end loop;
+      -- Events as rows without a job
+      for I in 1..Events.Count loop
+         Put_Line(File, Event_Kind'Image(Events.Get(I).Kind) & ",,"
+                  & Image(To_Duration(Events.Get(I).At_Time - Epoch)) & ",,,,");
+      end loop;
+      Close(File);
+   end Write_CSV;
+
+   procedure Write_JSON (File_Name : String) is
+      File : File_Type;
+      First : Boolean := True;
+   begin
+      Create(File, Out_File, File_Name);
+      Put_Line(File, "{");
+      Put_Line(File, "  ""calibration"": " & Image(Per_Ms) & ",");
+      Put_Line(File, "  ""tasks"": [");
+      for I in 1..Task_Count loop
+         Put(File, "    {""id"": " & Image(Params(I).Id)
+             & ", ""priority"": " & Image(Params(I).Priority)
+             & ", ""phase"": " & Image(Params(I).Phase)
+             & ", ""period"": " & Image(Params(I).Period)
+             & ", ""computation"": " & Image(Params(I).Computation_Time)
+             & ", ""deadline"": " & Image(Params(I).Relative_Deadline)
+             & ", ""budget"": " & Image(Params(I).Budget) & "}");
+         Put_Line(File, (if I < Task_Count then "," else ""));
+      end loop;
+      Put_Line(File, "  ],");
+      Put_Line(File, "  ""jobs"": [");
+      for I in 1..Task_Count loop
+         for N in 1..Logs(I).Count loop
+            declare
+               J : Job renames Logs(I).Jobs(N);
+            begin
+               if not First then
+                  Put_Line(File, ",");
+               end if;
+               First := False;
+               Put(File, "    {""task"": " & Image(Params(I).Id)
+                   & ", ""job"": " & Image(N)
+                   & ", ""release"": " & Image(To_Duration(J.Release - Epoch))
+                   & ", ""completion"": " & Image(To_Duration(J.Completion - Epoch))
+                   & ", ""response"": " & Image(To_Duration(J.Completion - J.Release))
+                   & ", ""missed"": " & (if Missed(Params(I), J) then "true" else "false")
+                   & ", ""overrun"": " & (if J.Overrun then "true" else "false") & "}");
+            end;
+         end loop;
+      end loop;
+      New_Line(File);
+      Put_Line(File, "  ],");
+      Put_Line(File, "  ""events"": [");
+      for I in 1..Events.Count loop
+         Put(File, "    {""event"": """ & Event_Kind'Image(Events.Get(I).Kind)
+             & """, ""time"": " & Image(To_Duration(Events.Get(I).At_Time - Epoch)) & "}");
+         Put_Line(File, (if I < Events.Count then "," else ""));
+      end loop;
+      Put_Line(File, "  ]");
+      Put_Line(File, "}");
+      Close(File);
+   end Write_JSON;
+
+   procedure Write_Trace (File_Name : String) is
+      File : File_Type;
+      Dropped : Natural := 0;
+      Job_No : Natural;
+      Open : Time;
+
+      -- Microseconds since the epoch, the time unit of the trace format
+      function Us (D : Time_Span) return String is
+        (Image(Integer(To_Duration(D) * 1_000_000)));
+
+      function Head (I : Positive) return String is
+        ("{""pid"": 1, ""tid"": " & Image(Params(I).Id) & ", ");
+   begin
+      Create(File, Out_File, File_Name);
+      Put_Line(File, "{""displayTimeUnit"": ""ms"", ""traceEvents"": [");
+      for I in 1..Task_Count loop
+         Put_Line(File, "  " & Head(I) & """ph"": ""M"", ""name"": ""thread_name"", ""args"": "
+                  & "{""name"": ""Task " & Image(Params(I).Id) & """}},");
+         Job_No := 0;
+         Open := Epoch;
+         for E of Traces(I).Events(1..Traces(I).Count) loop
+            case E.Kind is
+               when Released =>
+                  Put_Line(File, "  " & Head(I) & """ph"": ""i"", ""s"": ""t"", ""name"": ""release"", "
+                           & """ts"": " & Us(E.At_Time - Epoch) & "},");
+               when Started | Resumed =>
+                  if E.Kind = Started then
+                     Job_No := Job_No + 1;
+                  end if;
+                  Open := E.At_Time;
+               when Preempted | Finished =>
+                  -- One slice per stretch of execution
+                  Put(File, "  " & Head(I) & """ph"": ""X"", ""name"": """
+                      & (if Params(I).Background then "work" else "job " & Image(Job_No))
+                      & """, ""ts"": " & Us(Open - Epoch) & ", ""dur"": " & Us(E.At_Time - Open));
+                  if E.Kind = Finished and then not Params(I).Background
+                    and then Job_No in 1..Logs(I).Count
+                  then
+                     Put(File, ", ""args"": {""missed"": "
+                         & (if Missed(Params(I), Logs(I).Jobs(Job_No)) then "true" else "false")
+                         & ", ""overrun"": "
+                         & (if Logs(I).Jobs(Job_No).Overrun then "true" else "false") & "}");
+                  end if;
+                  Put_Line(File, "},");
+            end case;
+         end loop;
+         Dropped := Dropped + Traces(I).Dropped;
+      end loop;
+      -- Events of the other tasks as global instants
+      for I in 1..Events.Count loop
+         Put_Line(File, "  {""pid"": 1, ""tid"": 0, ""ph"": ""i"", ""s"": ""g"", ""name"": """
+                  & Event_Kind'Image(Events.Get(I).Kind) & """, ""ts"": "
+                  & Us(Events.Get(I).At_Time - Epoch) & "},");
+      end loop;
+      -- Last element, without a trailing comma
+      Put_Line(File, "  {""pid"": 1, ""ph"": ""M"", ""name"": ""process_name"", ""args"": "
+               & "{""name"": ""lab1B " & (if Use_EDF then "EDF" else "fixed priority") & """}}");
+      Put_Line(File, "], ""otherData"": {""calibration"": " & Image(Per_Ms)
+               & ", ""dropped"": " & Image(Dropped) & "}}");
+      Close(File);
+   end Write_Trace;
+
+   procedure Breakdown (Set : Task_Set; EDF : Boolean := False) is
+      Scaled : Task_Set := Set;
+      Last_OK : Float := 0.0;
+   begin
+      Put_Line("Dispatching: " & (if EDF then "EDF" else "fixed priority"));
+      for Percent in 10..40 loop
+         for I in Scaled.Tasks'Range loop
+            Scaled.Tasks(I).Computation_Time :=
+              Set.Tasks(I).Computation_Time * Percent * 5 / 100;
+         end loop;
+         Run(Scaled, EDF);
+         Put("Scale" & Integer'Image(Percent * 5) & " %, utilisation ");
+         Ada.Float_Text_IO.Put(Utilisation(Scaled), Fore => 1, Aft => 3, Exp => 0);
+         Put_Line(", deadline misses:" & Integer'Image(Misses));
+         exit when Misses > 0;
+         Last_OK := Utilisation(Scaled);
+      end loop;
+      Put("Breakdown utilisation: ");
+      Ada.Float_Text_IO.Put(Last_OK, Fore => 1, Aft => 3, Exp => 0);
+      New_Line;
+   end Breakdown;
+
+   procedure Quantum_Sweep (Set : Task_Set) is
+      One : Task_Set := Set;
+      Worst : Time_Span;
+   begin
+      Put_Line("Quantum (ms)" & ASCII.HT & "units/s" & ASCII.HT & "Jain" & ASCII.HT
+               & "switches/s" & ASCII.HT & "WCRT (s)" & ASCII.HT & "misses");
+      for Q of Set.Quanta(1..Set.Quantum_Count) loop
+         One.Quanta(1) := Q;
+         One.Quantum_Count := 1;
+         Run(One);
+         Worst := Time_Span_Zero;
+         for I in 1..Task_Count loop
+            if not Params(I).Background and then WCRT(I) > Worst then
+               Worst := WCRT(I);
+            end if;
+         end loop;
+         Put(Integer'Image(Q) & ASCII.HT);
+         Ada.Float_Text_IO.Put(Throughput, Fore => 1, Aft => 1, Exp => 0);
+         Put(ASCII.HT);
+         Ada.Float_Text_IO.Put(Fairness, Fore => 1, Aft => 3, Exp => 0);
+         Put(ASCII.HT);
+         Ada.Float_Text_IO.Put(Switch_Rate, Fore => 1, Aft => 1, Exp => 0);
+         Put(ASCII.HT);
+         Ada.Float_Text_IO.Put(Float(To_Duration(Worst)), Fore => 1, Aft => 3, Exp => 0);
+         Put_Line(ASCII.HT & Integer'Image(Misses));
+      end loop;
+   end Quantum_Sweep;
+
+   procedure Experiment (Default_Config : String; Default_Output : String;
+                         EDF : Boolean := False) is
+      use Ada.Command_Line;
+
+      Search : constant Boolean := Argument_Count >= 1 and then Argument(1) = "-b";
+      First : constant Natural := (if Search then 1 else 0);
+
+      function Arg (N : Positive; Default : String) return String is
+        (if Argument_Count >= First + N then Argument(First + N) else Default);
+
+      Output : constant String := Arg(2, Default_Output);
+      Trace : constant String := Arg(3, "");
+   begin
+      if Search then
+         Breakdown(Load(Arg(1, Default_Config)), EDF);
+         return;
+      end if;
+      declare
+         Set : constant Task_Set := Load(Arg(1, Default_Config));
+      begin
+         if Set.Quantum_Count > 1 and not EDF then
+            Quantum_Sweep(Set);
+            return;
+         end if;
+         Run(Set, EDF);
+      end;
+      if Output'Length > 5 and then Output(Output'Last - 4 .. Output'Last) = ".json" then
+         Write_JSON(Output);
+      else
+         Write_CSV(Output);
+      end if;
+      Put_Summary;
+      Put_Line("Jobs written to " & Output);
+      if Trace /= "" then
+         Write_Trace(Trace);
+         Put_Line("Trace written to " & Trace);
+      end if;
+   exception
+      when others =>
+         -- Release the other tasks of the program, or it never ends
+         Start.Abandon;
+         raise;
+   end Experiment;
+
+begin
+   Calibrate;
+end Workload;
@@ -0,0 +1,178 @@
+/**
+ * @file controller.c
+ * @brief Cruise control law, see controller.h.
+ */
+#include "controller.h"
+#include "vehicle.h"
+
+#define Q16_ONE     65536
+#define Q16_HALF    32768
+
+int32_t feed_forward(uint16_t velocity, int16_t terrain) {
+    // Vehicle: acceleration = drive / 2 - (wind + terrain).
+    return 2 * (wind_retardation(velocity) + terrain);
+}
+
+void pid_reset(PidState_t *pid, uint16_t throttle, uint16_t gain,
+               uint16_t velocity, int16_t terrain) {
+    int32_t drive = ((int32_t) throttle * gain) >> 8;
+
+    pid->integral = (drive - feed_forward(velocity, terrain)) * Q16_ONE;
+    pid->last_velocity = velocity;
+}
+
+uint16_t pid_update(PidState_t *pid, const PidGains_t *gains, uint16_t gain, uint16_t elapsed,
+                    uint16_t cruise_velocity, uint16_t velocity, int16_t terrain) {
+    int32_t error = (int32_t) cruise_velocity - velocity;
+    int32_t ff = feed_forward(velocity, terrain);
+    int32_t drive_max = ((int32_t) THROTTLE_MAX * gain) >> 8;
+    int32_t out;
+    int32_t integral;
+    int32_t derivative = 0;
+
+    // Ki and Kd are per Control period: scale them by the time since
+    // the last update, which an early release (BUTTON_IRQ) shortens.
+    integral = pid->integral
+             + (int32_t) (((int64_t) gains->ki * error * elapsed) / ELAPSED_ONE);
+    if (elapsed != 0)
+        derivative = (int32_t) (((int64_t) gains->kd * ((int32_t) velocity - pid->last_velocity)
+                                 * ELAPSED_ONE) / elapsed);
+    out = ff * Q16_ONE + gains->kp * error + integral - derivative;
+    out = (out + Q16_HALF) >> 16;
+    if (elapsed != 0)
+        pid->last_velocity = velocity;
+
+    // Anti-windup: keep the integral only if it does not push
+    // further into saturation.
+    if (out > drive_max) {
+        if (error < 0)
+            pid->integral = integral;
+        return THROTTLE_MAX;
+    }
+    if (out < 0) {
+        if (error > 0)
+            pid->integral = integral;
+        return 0;
+    }
+    pid->integral = integral;
+    if (gain != DRIVE_GAIN_ONE) {
+        out = (out * 256 + gain / 2) / gain;
+        if (out > THROTTLE_MAX)
+            out = THROTTLE_MAX;
+    }
+    return (uint16_t) out;
+}
+
+uint16_t bang_bang_update(uint16_t throttle, uint16_t cruise_velocity, uint16_t velocity) {
+    // Idea is based on this equation but throttle cannot be negative...
+    // throttle += 8 * (cruise_velocity - velocity);
+    // Retardation varies between approx. (-15, 17) 
+    //so taking the average we get constant 8.
+    // Holds +/- 4 (V) for lower velocities, as V goes higher (>70) it starts
+    // to be more wavy amplified.
+
+    // Current V is above desired V.
+    if(cruise_velocity < velocity) {
+        throttle = 0;
+    }
+
+    // Current V is below desired V
+    if(cruise_velocity > velocity) {
+        throttle += 8;
+        if(throttle > 80) {
+            throttle = 80;
+        }
+    }
+    return throttle;
+}
+
+void cruise_init(CruiseControl_t *cc) {
+    static const PidGains_t gains = PID_GAINS_DEFAULT;
+
+    cc->state = IDLE;
+    cc->law = CRUISE_CONTROLLER;
+    cc->terrain_ff = CONTROLLER_TERRAIN_FF;
+    cc->slope = 0;
+    cc->cruise_velocity = 0;
+    cc->throttle = 0;
+    cc->drive_gain = DRIVE_GAIN_ONE;
+    cc->elapsed = ELAPSED_ONE;
+    cc->gains = gains;
+    pid_reset(&cc->pid, 0, DRIVE_GAIN_ONE, 0, 0);
+}
+
+static int16_t terrain(const CruiseControl_t *cc, uint16_t position) {
+    if (cc->terrain_ff == TERRAIN_FF_SLOPE)
+        return cc->slope;
+    if (cc->terrain_ff == TERRAIN_FF_MAP)
+        return terrain_retardation(position);
+    return 0;
+}
+
+uint16_t cruise_update(CruiseControl_t *cc, bool cruise_control_button,
+                       bool gas_pedal, bool brake_pedal,
+                       uint16_t velocity, uint16_t position) {
+    switch (cc->state)
+    {
+        case IDLE: {
+            if(cruise_control_button == 1)
+                cc->state = CRUISE_INIT;
+        } break;
+        case CRUISE_INIT: {
+            // Wait for button to be unpressed. This state also sets the
+            // desired cruise velocity held by the CRUISE_ACTIVE state.
+            if(cruise_control_button == 0) {
+                cc->state = CRUISE_ACTIVE;
+                cc->cruise_velocity = velocity;
+                pid_reset(&cc->pid, cc->throttle, cc->drive_gain, velocity,
+                          terrain(cc, position));
+            }
+        } break;
+        case CRUISE_ACTIVE: {
+            // While in CRUISE if conditions no longer hold go directly to idle.
+            if(gas_pedal || brake_pedal || (velocity < 25)) {
+                cc->state = IDLE;
+            }
+
+            // If cruise button is pressed again go to cruise exit that works the 
+            // same as cruiseinit (i.e. smooth button pressing)
+            if(cruise_control_button == 1) {
+                cc->state = CRUISE_EXIT;
+            }
+
+            if (cc->law == 0)
+                cc->throttle = bang_bang_update(cc->throttle, cc->cruise_velocity, velocity);
+            else
+                cc->throttle = pid_update(&cc->pid, &cc->gains, cc->drive_gain, cc->elapsed,
+                                          cc->cruise_velocity, velocity,
+                                          terrain(cc, position));
+        } break;
+        case CRUISE_EXIT: {
+            if(cruise_control_button == 0)
+                cc->state = IDLE;
+        } break;
+        
+        default: {
+            cc->state = IDLE;
+        } break;
+    }
+
+    if (gas_pedal) {
+        cc->throttle += GAS_STEP; 
+        if (cc->throttle > THROTTLE_MAX) {
+            cc->throttle = THROTTLE_MAX;
+        }
+    }
+    else 
+    {
+        // Case Nothing: (same as braking)
+        // If we brake the state goes to IDLE.
+        // Should we be outside where the state != IDLE
+        // then we should not do anything with throttle here
+        // it will be handled in the cruise_control.
+        if(cc->state == IDLE) {
+            cc->throttle = 0;
+        }
+    }
+    return cc->throttle;
+}
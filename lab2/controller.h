@@ -0,0 +1,124 @@
+/**
+ * @file controller.h
+ * @brief Cruise control law.
+ *
+ *        CRUISE_CONTROLLER selects the law used in CRUISE_ACTIVE:
+ *        0  the original bang-bang law (throttle 0 above the set
+ *           point, +8 below it),
+ *        1  fixed-point PI,
+ *        2  fixed-point PID (derivative on the measured velocity).
+ *        The PI(D) adds feed-forward of the wind and terrain
+ *        retardation, and stops integrating while the output is
+ *        saturated (anti-windup). CONTROLLER_TERRAIN_FF selects where
+ *        the terrain term comes from:
+ *        0  none, only the wind is fed forward,
+ *        1  the slope estimated from the accelerometer (slope.h),
+ *        2  the terrain map of vehicle.c at the current position. Gains are Q16 fixed point (65536 = 1.0) per
+ *        Control period; no float is used.
+ *
+ *        The gains assume one update per Control period. With
+ *        BUTTON_IRQ Control is also released early on input changes,
+ *        so the integral and derivative are scaled by the time since
+ *        the last update (elapsed, Q8 Control periods).
+ *
+ *        The PI(D) works in drive, the throttle of the plant without
+ *        gearbox, and divides by the Q8 gain of the engaged gear
+ *        (gearbox.h; 256 without gearbox) to get the throttle.
+ *
+ *        cruise_update() is the mode logic of the Control task (cruise
+ *        button, pedals, throttle) without any kernel or BSP call, so
+ *        that the host plant simulator (plant_sim.h) runs the same code.
+ */
+#ifndef CONTROLLER_H
+#define CONTROLLER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef CRUISE_CONTROLLER
+#define CRUISE_CONTROLLER   1
+#endif
+
+/* Throttle per unit of velocity error */
+#ifndef CONTROLLER_KP
+#define CONTROLLER_KP       (3 * 65536)
+#endif
+/* Throttle per unit of velocity error and Control period */
+#ifndef CONTROLLER_KI
+#define CONTROLLER_KI       (65536 / 2)
+#endif
+/* Throttle per unit of velocity change in one Control period */
+#ifndef CONTROLLER_KD
+#define CONTROLLER_KD       (CRUISE_CONTROLLER == 2 ? 2 * 65536 : 0)
+#endif
+
+#define TERRAIN_FF_NONE     0
+#define TERRAIN_FF_SLOPE    1
+#define TERRAIN_FF_MAP      2
+
+#ifndef CONTROLLER_TERRAIN_FF
+#define CONTROLLER_TERRAIN_FF   TERRAIN_FF_MAP
+#endif
+
+#define THROTTLE_MAX        80
+#define GAS_STEP            2   /* Defines how much the throttle is increased if GAS_STEP is asserted */
+
+#define PID_GAINS_DEFAULT   { CONTROLLER_KP, CONTROLLER_KI, CONTROLLER_KD }
+
+// Cruise control FSM machine.
+typedef enum {
+    IDLE = 0,
+    CRUISE_INIT = 1,
+    CRUISE_ACTIVE = 2,
+    CRUISE_EXIT = 3 
+} STATE;
+
+typedef struct {
+    int32_t kp, ki, kd;     /* Q16 */
+} PidGains_t;
+
+typedef struct {
+    int32_t  integral;      /* Q16 throttle */
+    uint16_t last_velocity;
+} PidState_t;
+
+typedef struct {
+    uint8_t    state;           /* STATE */
+    uint8_t    law;             /* as CRUISE_CONTROLLER */
+    uint8_t    terrain_ff;      /* as CONTROLLER_TERRAIN_FF */
+    int16_t    slope;           /* TERRAIN_FF_SLOPE: estimate, set before each update */
+    uint16_t   cruise_velocity;
+    uint16_t   throttle;
+    uint16_t   drive_gain;      /* Q8 drive per throttle, set before each update */
+    uint16_t   elapsed;         /* Q8 Control periods since the last update, set before each update */
+    PidGains_t gains;
+    PidState_t pid;
+} CruiseControl_t;
+
+#define DRIVE_GAIN_ONE      256     /* Q8, no gearbox */
+#define ELAPSED_ONE         256     /* Q8, one Control period */
+
+/* Bumpless start from the current throttle. terrain is the terrain
+ * retardation to feed forward (0.1 m/s^2). */
+void pid_reset(PidState_t *pid, uint16_t throttle, uint16_t gain,
+               uint16_t velocity, int16_t terrain);
+
+/* elapsed: time since the last update in Q8 Control periods */
+uint16_t pid_update(PidState_t *pid, const PidGains_t *gains, uint16_t gain, uint16_t elapsed,
+                    uint16_t cruise_velocity, uint16_t velocity, int16_t terrain);
+
+uint16_t bang_bang_update(uint16_t throttle, uint16_t cruise_velocity, uint16_t velocity);
+
+/* Drive that holds velocity against the wind and terrain (zero acceleration). */
+int32_t feed_forward(uint16_t velocity, int16_t terrain);
+
+/* IDLE, zero throttle, drive gain 1.0, one period elapsed, CRUISE_CONTROLLER law,
+ * CONTROLLER_TERRAIN_FF and the CONTROLLER_K* gains. */
+void cruise_init(CruiseControl_t *cc);
+
+/* One Control period; returns the new throttle. */
+uint16_t cruise_update(CruiseControl_t *cc, bool cruise_control_button,
+                       bool gas_pedal, bool brake_pedal,
+                       uint16_t velocity, uint16_t position);
+
+#endif /* CONTROLLER_H */
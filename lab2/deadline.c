@@ -0,0 +1,107 @@
+/**
+ * @file deadline.c
+ * @brief Deadline-miss detection and graceful degradation, see deadline.h.
+ */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "log.h"
+#include "deadline.h"
+
+static const char *const names[DL_TASK_COUNT] = {
+    "Button", "Vehicle", "Control", "Display", "ExtraLoad", "Watchdog", "Overload",
+    "Gearbox", "Slope"
+};
+
+/* Single writer per entry (the task itself); 32-bit stores are atomic. */
+static volatile DeadlineStats_t stats[DL_TASK_COUNT];
+static volatile uint8_t level = DEGRADE_NONE;
+
+/* Control task only */
+static uint32_t seen_misses[DL_TASK_COUNT];
+static uint32_t clean_periods;
+
+void vDeadlineCheck(DeadlineTask_t task, TickType_t xDeadline) {
+    TickType_t xLateness = xTaskGetTickCount() - xDeadline;
+
+    stats[task].jobs++;
+    // Wraparound safe: late if now is past the deadline.
+    if ((int32_t) xLateness > 0) {
+        stats[task].misses++;
+        if (xLateness > stats[task].max_lateness)
+            stats[task].max_lateness = xLateness;
+    }
+}
+
+void vDeadlineDelayUntil(DeadlineTask_t task, TickType_t *pxLastWakeTime, TickType_t xPeriod) {
+    vDeadlineCheck(task, *pxLastWakeTime + xPeriod);
+    vTaskDelayUntil(pxLastWakeTime, xPeriod);
+}
+
+DegradeLevel_t xDeadlineUpdate(void) {
+    bool missed = false;
+    uint32_t misses;
+    int i;
+#if DEGRADE_ON_MISS
+    uint8_t old_level, new_level;
+#endif
+
+    for (i = 0; i < DL_TASK_COUNT; i++) {
+        misses = stats[i].misses;
+        if (misses == seen_misses[i])
+            continue;
+        LOG3(LOG_CH_CONTROL, LOG_DEADLINE_MISS, i, misses, stats[i].max_lateness);
+        seen_misses[i] = misses;
+        // ExtraLoad is what gets shed, its own misses do not count.
+        if (i != DL_EXTRALOAD)
+            missed = true;
+    }
+
+#if DEGRADE_ON_MISS
+    // Watchdog (higher priority, or the other core) may escalate in
+    // between: read, change and write the level in one critical section.
+    taskENTER_CRITICAL();
+    old_level = level;
+    new_level = old_level;
+    if (missed) {
+        clean_periods = 0;
+        if (new_level < DEGRADE_MAX)
+            new_level++;
+    } else if (new_level > DEGRADE_NONE && ++clean_periods >= DEADLINE_RECOVER_PERIODS) {
+        clean_periods = 0;
+        new_level--;
+    }
+    level = new_level;
+    taskEXIT_CRITICAL();
+    if (new_level != old_level)
+        LOG1(LOG_CH_CONTROL, LOG_DEGRADE, new_level);
+    return (DegradeLevel_t) new_level;
+#else
+    (void) missed;
+    return (DegradeLevel_t) level;
+#endif
+}
+
+void vDeadlineEscalate(void) {
+#if DEGRADE_ON_MISS
+    level = DEGRADE_MAX;
+#endif
+}
+
+DegradeLevel_t xDeadlineLevel(void) {
+    return (DegradeLevel_t) level;
+}
+
+void vDeadlineStatus(DeadlineStatus_t *status) {
+    int i;
+
+    for (i = 0; i < DL_TASK_COUNT; i++) {
+        status->task[i].jobs = stats[i].jobs;
+        status->task[i].misses = stats[i].misses;
+        status->task[i].max_lateness = stats[i].max_lateness;
+    }
+    status->level = level;
+}
+
+const char *pcDeadlineTaskName(DeadlineTask_t task) {
+    return task < DL_TASK_COUNT ? names[task] : "?";
+}
@@ -0,0 +1,84 @@
+/**
+ * @file deadline.h
+ * @brief Deadline-miss detection and graceful degradation of the
+ *        cruise control task set.
+ *
+ *        Each periodic task ends its job with vDeadlineDelayUntil()
+ *        instead of vTaskDelayUntil(). A job that completes after its
+ *        deadline (the next release, deadlines are implicit) counts
+ *        as a miss of that task, together with its lateness. Every
+ *        task only writes its own counters; xDeadlineStatus() gives
+ *        the counters and the degradation level in one place.
+ *
+ *        The Control task calls xDeadlineUpdate() once per period: a
+ *        new miss of any task but ExtraLoad raises the degradation
+ *        level one step, DEADLINE_RECOVER_PERIODS periods without a
+ *        miss lower it one step.
+ *          DEGRADE_SHED_LOAD     ExtraLoad skips its busy wait,
+ *          DEGRADE_SLOW_DISPLAY  and Display runs DISPLAY_SLOWDOWN
+ *                                times less often.
+ *        When the load starves Control itself, the Watchdog raises the
+ *        level to the maximum (vDeadlineEscalate()).
+ */
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "FreeRTOS.h"
+
+#ifndef DEGRADE_ON_MISS
+#define DEGRADE_ON_MISS 1   /* 0: only count misses, never degrade */
+#endif
+
+#define DEADLINE_RECOVER_PERIODS    25  /* Control periods without a miss */
+#define DISPLAY_SLOWDOWN            4
+
+typedef enum {
+    DL_BUTTON = 0,
+    DL_VEHICLE,
+    DL_CONTROL,
+    DL_DISPLAY,
+    DL_EXTRALOAD,
+    DL_WATCHDOG,
+    DL_OVERLOAD,
+    DL_GEARBOX,
+    DL_SLOPE,
+    DL_TASK_COUNT
+} DeadlineTask_t;
+
+typedef enum {
+    DEGRADE_NONE = 0,
+    DEGRADE_SHED_LOAD,
+    DEGRADE_SLOW_DISPLAY,
+    DEGRADE_MAX = DEGRADE_SLOW_DISPLAY
+} DegradeLevel_t;
+
+typedef struct {
+    uint32_t jobs;
+    uint32_t misses;
+    uint32_t max_lateness;  /* ticks */
+} DeadlineStats_t;
+
+typedef struct {
+    DeadlineStats_t task[DL_TASK_COUNT];
+    uint8_t         level;  /* DegradeLevel_t */
+} DeadlineStatus_t;
+
+/* Accounts the job of task that completes now against xDeadline. */
+void vDeadlineCheck(DeadlineTask_t task, TickType_t xDeadline);
+
+/* vDeadlineCheck() for the deadline *pxLastWakeTime + xPeriod, then vTaskDelayUntil(). */
+void vDeadlineDelayUntil(DeadlineTask_t task, TickType_t *pxLastWakeTime, TickType_t xPeriod);
+
+/* Control task: applies the policy above; returns the new level. */
+DegradeLevel_t xDeadlineUpdate(void);
+
+/* Watchdog: overload detected, degrade as far as possible. */
+void vDeadlineEscalate(void);
+
+DegradeLevel_t xDeadlineLevel(void);
+void vDeadlineStatus(DeadlineStatus_t *status);
+const char *pcDeadlineTaskName(DeadlineTask_t task);
+
+#endif /* DEADLINE_H */
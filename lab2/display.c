@@ -0,0 +1,79 @@
+/**
+ * @file display.c
+ * @brief Seven-segment and shift-register output, see display.h.
+ */
+#include <string.h>
+#include "bsp.h"
+#include "display.h"
+
+#define TENS(t) t "0" t "1" t "2" t "3" t "4" t "5" t "6" t "7" t "8" t "9"
+
+/* "00" "01" ... "99" */
+static const char two_digits[200] =
+    TENS("0") TENS("1") TENS("2") TENS("3") TENS("4")
+    TENS("5") TENS("6") TENS("7") TENS("8") TENS("9");
+
+static char seg7[DISPLAY_DIGITS + 1];
+static uint8_t sr[DISPLAY_SR_BYTES];
+static DisplayStats_t stats;
+
+static void put_two_digits(char *dst, uint16_t value) {
+    if (value > 99)
+        value = 99;
+    dst[0] = two_digits[2 * value];
+    dst[1] = two_digits[2 * value + 1];
+}
+
+void vDisplayInit(void) {
+    BSP_7SegClear();
+    BSP_7SegBrightness(7);
+
+    // Cannot match any frame: the first update writes everything.
+    memset(seg7, ' ', DISPLAY_DIGITS);
+    seg7[DISPLAY_DIGITS] = '\0';
+    memset(sr, 0, sizeof(sr));
+    memset(&stats, 0, sizeof(stats));
+    BSP_ShiftRegWriteAll(sr);
+}
+
+void vDisplayUpdate(uint16_t throttle, uint16_t velocity, uint16_t position, uint8_t gear) {
+    char new_seg7[DISPLAY_DIGITS];
+    uint8_t new_sr[DISPLAY_SR_BYTES] = { 0 };
+    uint8_t step = (position / 1000) % 24;
+    uint32_t changed;
+    int i;
+
+    stats.frames++;
+
+    // THROTTLE is placed in U14, U15 and VELOCITY (m/s) in U16, U17
+    put_two_digits(&new_seg7[0], throttle);
+    if (gear != 0) {
+        // Gear in U14, throttle in tens in U15
+        new_seg7[0] = two_digits[2 * (gear % 10) + 1];
+        new_seg7[1] = two_digits[2 * (throttle / 10 % 10) + 1];
+    }
+    put_two_digits(&new_seg7[2], velocity / 10);
+    for (changed = 0, i = 0; i < DISPLAY_DIGITS; i++)
+        changed += new_seg7[i] != seg7[i];
+    if (changed != 0) {
+        memcpy(seg7, new_seg7, DISPLAY_DIGITS);
+        BSP_7SegDispString(seg7);
+        stats.seg7_writes++;
+        stats.digits_changed += changed;
+    }
+
+    // One of the 24 LEDs per 1000 position units.
+    new_sr[step / 8] = 1u << (step % 8);
+    for (changed = 0, i = 0; i < DISPLAY_SR_BYTES; i++)
+        changed += new_sr[i] != sr[i];
+    if (changed != 0) {
+        memcpy(sr, new_sr, DISPLAY_SR_BYTES);
+        BSP_ShiftRegWriteAll(sr);
+        stats.sr_writes++;
+        stats.bytes_changed += changed;
+    }
+}
+
+void vDisplayStats(DisplayStats_t *pxStats) {
+    *pxStats = stats;
+}
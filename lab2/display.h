@@ -0,0 +1,44 @@
+/**
+ * @file display.h
+ * @brief Seven-segment and shift-register output of the Display task.
+ *
+ *        A frame is the four digits (throttle in U14/U15, velocity in
+ *        m/s in U16/U17, both clamped to 99) and the three shift-register
+ *        bytes with one LED per 1000 position units. With the gearbox
+ *        (gearbox.h) U14 shows the gear and U15 the throttle in tens. The digits come
+ *        from a two-digit table instead of sprintf. Each new frame is
+ *        compared with the last one written, and only a part that
+ *        changed is sent to the BSP.
+ *
+ *        The BSP only takes the whole 4-digit string and all three
+ *        shift-register bytes, so a change of one digit or byte rewrites
+ *        that whole part. The counters show how much is skipped.
+ */
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <stdint.h>
+
+#define DISPLAY_DIGITS      4
+#define DISPLAY_SR_BYTES    3
+#define DISPLAY_STATS_FRAMES 20     /* frames between two logs of the counters */
+
+typedef struct {
+    uint32_t frames;
+    uint32_t seg7_writes;
+    uint32_t sr_writes;
+    uint32_t digits_changed;
+    uint32_t bytes_changed;
+} DisplayStats_t;
+
+/* Clears the display; the next frame is written in full. */
+void vDisplayInit(void);
+
+/* gear is GEAR_NONE (0) without gearbox. */
+void vDisplayUpdate(uint16_t throttle, uint16_t velocity, uint16_t position, uint8_t gear);
+
+/* Counters since vDisplayInit(), logged by the Display task every
+ * DISPLAY_STATS_FRAMES frames (LOG_DISPLAY_SEG7, LOG_DISPLAY_SR). */
+void vDisplayStats(DisplayStats_t *stats);
+
+#endif /* DISPLAY_H */
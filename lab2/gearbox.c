@@ -0,0 +1,76 @@
+/**
+ * @file gearbox.c
+ * @brief Gearbox of the cruise control plant, see gearbox.h.
+ */
+#include "vehicle.h"
+#include "gearbox.h"
+
+#define RPM_SHIFT       6       /* engine speed units per torque table entry: 64 */
+#define RPM_ENTRIES     16
+
+/* Gear ratio, Q8; index 0 is GEAR_NONE */
+static const uint16_t ratio[GEAR_COUNT + 1] = { 256, 640, 448, 346, 282, 230 };
+
+/* Engine torque over engine speed (velocity * ratio), Q8 of the peak */
+static const uint8_t torque[RPM_ENTRIES] = {
+    128, 160, 192, 224, 240, 255, 255, 255,
+    248, 240, 224, 208, 192, 160, 128,  96
+};
+
+/* Automatic shift points with hysteresis, velocity in 0.1 m/s:
+ * up[g] shifts g -> g + 1, down[g] shifts g -> g - 1. */
+static const uint16_t up[GEAR_COUNT + 1]   = { 0, 120, 200, 290, 380, 0xFFFF };
+static const uint16_t down[GEAR_COUNT + 1] = { 0,   0, 100, 170, 250,    340 };
+
+void gearbox_init(Gearbox_t *gb) {
+    gb->gear = 1;
+    gb->shifts = 0;
+}
+
+uint8_t gearbox_select(Gearbox_t *gb, uint8_t selector, uint16_t velocity) {
+    uint8_t gear = gb->gear;
+
+    if (selector != GEAR_AUTO)
+        gear = selector > GEAR_COUNT ? GEAR_COUNT : selector;
+    else if (velocity > up[gear])
+        gear++;
+    else if (velocity < down[gear])
+        gear--;
+
+    if (gear != gb->gear) {
+        gb->gear = gear;
+        gb->shifts++;
+    }
+    return gear;
+}
+
+uint16_t gearbox_gain(uint8_t gear, uint16_t velocity) {
+    uint32_t rpm;
+
+    if (gear == GEAR_NONE || gear > GEAR_COUNT)
+        return GEAR_GAIN_ONE;
+    rpm = ((uint32_t) velocity * ratio[gear]) >> (8 + RPM_SHIFT);
+    if (rpm >= RPM_ENTRIES)
+        rpm = RPM_ENTRIES - 1;      /* rev limiter */
+    return (uint16_t) ((ratio[gear] * torque[rpm]) >> 8);
+}
+
+int16_t gearbox_thrust(uint16_t throttle, uint8_t gear, uint16_t velocity) {
+    return (int16_t) ((((uint32_t) throttle * gearbox_gain(gear, velocity)) >> 8) / 2);
+}
+
+int8_t gearbox_acceleration(uint16_t throttle, uint8_t gear,
+                            uint16_t position, uint16_t velocity) {
+    int32_t acceleration;
+
+    if (gear == GEAR_NONE)
+        return vehicle_acceleration(throttle, position, velocity);
+
+    acceleration = (int32_t) gearbox_thrust(throttle, gear, velocity)
+                 - vehicle_retardation(position, velocity);
+    if (acceleration > INT8_MAX)
+        acceleration = INT8_MAX;
+    else if (acceleration < INT8_MIN)
+        acceleration = INT8_MIN;
+    return (int8_t) acceleration;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file gearbox.h
+ * @brief Gearbox of the cruise control plant (conditional task).
+ *
+ *        The throttle drives the engine; the engaged gear multiplies its
+ *        torque by the gear ratio, and the torque depends on the engine
+ *        speed (velocity times ratio). Both are tables, so the gain and
+ *        the shift decision cost two lookups and a multiply.
+ *
+ *        The "drive" is the throttle the original plant needed for the
+ *        same acceleration (acceleration = drive / 2 - retardation).
+ *        gearbox_gain() is drive per unit of throttle, Q8: the Control
+ *        task computes its law in drive and divides by the gain, so a
+ *        shift does not disturb the velocity.
+ *
+ *        Gear 0 means no gearbox: gain 1.0 and the plant of vehicle.c.
+ *        Plain C without FreeRTOS, like vehicle.c.
+ */
+#ifndef GEARBOX_H
+#define GEARBOX_H
+
+#include <stdint.h>
+
+#ifndef GEARBOX
+#define GEARBOX 0   /* 1: Gearbox task and geared plant */
+#endif
+
+#define GEAR_COUNT          5
+#define GEAR_NONE           0
+#define GEAR_AUTO           0       /* selector: automatic shifting */
+#define GEAR_GAIN_ONE       256     /* Q8 */
+
+/* Manual selector on SW_10..SW_12 (switch bits 7..5), 0 = automatic */
+#define GEAR_SELECT_SHIFT   5
+#define GEAR_SELECT_MASK    0xE0u
+
+typedef struct {
+    uint8_t  gear;      /* 1..GEAR_COUNT */
+    uint32_t shifts;
+} Gearbox_t;
+
+/* First gear. */
+void gearbox_init(Gearbox_t *gb);
+
+/* One shift decision: selector 1..GEAR_COUNT holds that gear, GEAR_AUTO
+ * follows the shift points; at most one gear per call. Returns the gear. */
+uint8_t gearbox_select(Gearbox_t *gb, uint8_t selector, uint16_t velocity);
+
+/* Drive per unit of throttle in gear at velocity, Q8. */
+uint16_t gearbox_gain(uint8_t gear, uint16_t velocity);
+
+/* Acceleration from the engine alone: drive / 2, 0.1 m/s^2. */
+int16_t gearbox_thrust(uint16_t throttle, uint8_t gear, uint16_t velocity);
+
+/* vehicle_acceleration() with the throttle through gear. */
+int8_t gearbox_acceleration(uint16_t throttle, uint8_t gear,
+                            uint16_t position, uint16_t velocity);
+
+#endif /* GEARBOX_H */
@@ -0,0 +1,152 @@
+/**
+ * @file input.c
+ * @brief Pedal, cruise button and load switch input, see input.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "bsp.h"
+#include "trace.h"
+#include "mem.h"
+#include "input.h"
+
+#ifndef SIM_TICKS_PER_WALL_MS
+#include "hardware/gpio.h"
+#endif
+
+#define N_INPUTS 11
+
+/* Input in bit position n of the input word; the BSP input ids are
+ * the RP2040 GPIO numbers. */
+static const uint8_t input_pin[N_INPUTS] = {
+    SW_17, SW_16, SW_15, SW_14, SW_13, SW_12, SW_11, SW_10,
+    GAS_PEDAL, BRAKE_PEDAL, CRUISE_CONTROL
+};
+
+/* Pedals and the cruise button are pull-up, pressed reads 0. */
+#define INPUT_ACTIVE_LOW    (INPUT_GAS | INPUT_BRAKE | INPUT_CRUISE)
+
+uint16_t usInputRead(void) {
+#ifdef SIM_TICKS_PER_WALL_MS
+    uint32_t port = SIM_ReadInputs();
+#else
+    uint32_t port = gpio_get_all();
+#endif
+    uint16_t inputs = 0;
+
+    for (int i = 0; i < N_INPUTS; i++)
+        inputs |= ((port >> input_pin[i]) & 1u) << i;
+    return inputs ^ INPUT_ACTIVE_LOW;
+}
+
+#if BUTTON_IRQ
+static TaskHandle_t xWaiting_handle;
+static TimerHandle_t xDebounceTimer;
+static uint16_t published;
+
+/* Runs in the timer task once the inputs were quiet for INPUT_DEBOUNCE_MS. */
+static void vDebounceCallback(TimerHandle_t timer) {
+    uint16_t inputs = usInputRead();
+
+    (void) timer;
+    if (inputs != published) {
+        published = inputs;
+        xTaskNotify(xWaiting_handle, inputs, eSetValueWithOverwrite);
+    }
+}
+
+/* Edge interrupt on any input, every bounce restarts the timer. */
+#ifdef SIM_TICKS_PER_WALL_MS
+static void vInputIsr(void) {
+#else
+static void vInputIsr(uint gpio, uint32_t events) {
+    (void) gpio;
+    (void) events;
+#endif
+    BaseType_t xWoken = pdFALSE;
+
+    xTimerResetFromISR(xDebounceTimer, &xWoken);
+    portYIELD_FROM_ISR(xWoken);
+}
+
+uint16_t usInputWait(void) {
+    uint32_t inputs;
+
+    if (xWaiting_handle == NULL) {
+        xWaiting_handle = xTaskGetCurrentTaskHandle();
+        xDebounceTimer = xMemTimerCreate("Debounce Timer", pdMS_TO_TICKS(INPUT_DEBOUNCE_MS),
+                                         pdFALSE, 0, vDebounceCallback);
+        published = usInputRead();
+#ifdef SIM_TICKS_PER_WALL_MS
+        SIM_SetInputIrq(vInputIsr);
+#else
+        gpio_set_irq_enabled_with_callback(input_pin[0], GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL,
+                                           true, vInputIsr);
+        for (int i = 1; i < N_INPUTS; i++)
+            gpio_set_irq_enabled(input_pin[i], GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true);
+#endif
+        return published;
+    }
+    xTaskNotifyWait(0, 0, &inputs, portMAX_DELAY);
+    return (uint16_t) inputs;
+}
+#endif
+
+#if INPUT_BENCH
+static uint32_t activations;
+static uint64_t button_us;
+static uint32_t first_us;
+static uint32_t seen_change_us;
+static uint32_t samples;
+static uint32_t lat_min = UINT32_MAX;
+static uint32_t lat_max;
+static uint64_t lat_sum;
+
+void vInputBenchButton(uint32_t start_us) {
+    if (activations == 0) {
+        first_us = start_us;
+#ifdef SIM_TICKS_PER_WALL_MS
+        atexit(vInputBenchReport);
+#endif
+    }
+    activations++;
+    button_us += ulTraceClockUs() - start_us;
+}
+
+/* Latency from the input change to Control acting on it. Only the host
+ * build knows when an input physically changed. */
+void vInputBenchConsumed(void) {
+#ifdef SIM_TICKS_PER_WALL_MS
+    uint32_t change_us = SIM_GetInputChangeUs();
+    uint32_t latency;
+
+    if (change_us == seen_change_us)
+        return;
+    seen_change_us = change_us;
+    latency = ulTraceClockUs() - change_us;
+    if (latency < lat_min)
+        lat_min = latency;
+    if (latency > lat_max)
+        lat_max = latency;
+    lat_sum += latency;
+    samples++;
+#endif
+}
+
+void vInputBenchReport(void) {
+    uint32_t elapsed_ms = (ulTraceClockUs() - first_us) / 1000;
+
+    if (elapsed_ms == 0)
+        elapsed_ms = 1;
+    printf("--- INPUT BENCH (%s) ---\n", BUTTON_IRQ ? "interrupt" : "polling");
+    printf("Button activations: %lu, CPU: %lu us per second\n",
+           (unsigned long) activations, (unsigned long) (button_us * 1000 / elapsed_ms));
+    if (samples != 0) {
+        printf("Input to Control latency (us) min: %lu, avg: %lu, max: %lu (%lu changes)\n",
+               (unsigned long) lat_min, (unsigned long) (lat_sum / samples),
+               (unsigned long) lat_max, (unsigned long) samples);
+    }
+}
+#endif
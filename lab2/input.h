@@ -0,0 +1,52 @@
+/**
+ * @file input.h
+ * @brief Pedal, cruise button and load switch input of the cruise control.
+ *
+ *        All eleven inputs are read with one port read and returned as
+ *        one word: the load switches in the low byte (SW_10 in bit 7
+ *        down to SW_17 in bit 0, as before) and the pressed state of
+ *        gas, brake and cruise above it.
+ *
+ *        With BUTTON_IRQ the inputs are event driven instead: an edge
+ *        interrupt (re)starts a one-shot debounce timer, and when it
+ *        expires a changed input word is sent to the waiting task as a
+ *        task notification.
+ */
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+
+#ifndef BUTTON_IRQ
+#define BUTTON_IRQ 0    /* 1: edge interrupts instead of 50 ms polling */
+#endif
+
+#ifndef INPUT_BENCH
+#define INPUT_BENCH 0   /* 1: measure Button CPU time and input latency */
+#endif
+
+#define CRUISE_CONTROL  SW_7
+#define GAS_PEDAL       SW_6
+#define BRAKE_PEDAL     SW_5
+
+#define INPUT_DEBOUNCE_MS   5
+
+#define INPUT_SWITCHES      0x00FFu
+#define INPUT_GAS           0x0100u
+#define INPUT_BRAKE         0x0200u
+#define INPUT_CRUISE        0x0400u
+
+/* Reads all inputs at once. */
+uint16_t usInputRead(void);
+
+/* BUTTON_IRQ: the first call arms the interrupts and returns the current
+ * inputs, every further call blocks until a debounced input changed. */
+uint16_t usInputWait(void);
+
+/* INPUT_BENCH: Button task time from start_us on, and the moment Control
+ * has read the inputs. The host build prints the results at exit. */
+void vInputBenchButton(uint32_t start_us);
+void vInputBenchConsumed(void);
+void vInputBenchReport(void);
+
+#endif /* INPUT_H */
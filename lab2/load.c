@@ -0,0 +1,114 @@
+/**
+ * @file load.c
+ * @brief Calibrated synthetic CPU load, see load.h.
+ */
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace.h"
+#include "deadline.h"
+#include "mem.h"
+#include "load.h"
+
+static uint32_t iters_per_us_q16;
+static volatile uint32_t sweep_percent;
+
+/* Not inlined: calibration and load must run the same code. */
+static void __attribute__((noinline)) spin(uint32_t n) {
+    while (n-- != 0)
+        __asm__ volatile ("" ::: "memory");
+}
+
+void vLoadCalibrate(void) {
+    uint32_t best = 0;
+    int run;
+
+    for (run = 0; run < LOAD_CALIBRATION_RUNS; run++) {
+        uint32_t n = 1024;
+        uint32_t start, elapsed;
+
+        // Double the iterations until one run is long enough to make
+        // the timer resolution negligible.
+        for (;;) {
+            start = ulTraceClockUs();
+            spin(n);
+            elapsed = ulTraceClockUs() - start;
+            if (elapsed >= LOAD_CALIBRATION_US || n >= 0x80000000u)
+                break;
+            n *= 2;
+        }
+        if (elapsed == 0)
+            elapsed = 1;
+        // An interrupt during the run only makes it slower.
+        if (((uint64_t) n << 16) / elapsed > best)
+            best = (uint32_t) (((uint64_t) n << 16) / elapsed);
+    }
+    iters_per_us_q16 = best;
+    printf("Load: %lu.%03lu iterations/us\n", (unsigned long) (best >> 16),
+           (unsigned long) (((best & 0xFFFF) * 1000u) >> 16));
+}
+
+uint32_t ulLoadItersPerUsQ16(void) {
+    return iters_per_us_q16;
+}
+
+void vLoadBurnUs(uint32_t ulUs) {
+    spin((uint32_t) (((uint64_t) ulUs * iters_per_us_q16 + 0x8000) >> 16));
+}
+
+uint32_t ulLoadUsForPercent(uint32_t ulPeriodUs, uint32_t ulPercent) {
+    if (ulPercent > 100)
+        ulPercent = 100;
+    return (uint32_t) (((uint64_t) ulPeriodUs * ulPercent + 50) / 100);
+}
+
+uint32_t ulLoadSweepPercent(void) {
+    return sweep_percent;
+}
+
+/* Per step and task, printed after the sweep: no output while it runs */
+static uint32_t sweep_misses[LOAD_SWEEP_STEPS][DL_TASK_COUNT];
+static uint32_t sweep_jobs[LOAD_SWEEP_STEPS][DL_TASK_COUNT];
+
+void vLoadSweepTask(void *args) {
+    static DeadlineStatus_t before, after;
+    uint32_t threshold = 0;
+    bool missed = false;
+    int step;
+    int i;
+
+    (void) args;
+    for (step = 0; step < LOAD_SWEEP_STEPS; step++) {
+        vDeadlineStatus(&before);
+        sweep_percent = step * LOAD_SWEEP_STEP;
+        vTaskDelay(LOAD_SWEEP_DWELL);
+        vDeadlineStatus(&after);
+
+        for (i = 0; i < DL_TASK_COUNT; i++) {
+            sweep_misses[step][i] = after.task[i].misses - before.task[i].misses;
+            sweep_jobs[step][i] = after.task[i].jobs - before.task[i].jobs;
+        }
+    }
+    sweep_percent = 0;
+
+    for (step = 0; step < LOAD_SWEEP_STEPS; step++) {
+        printf("Sweep %3lu%%:", (unsigned long) (step * LOAD_SWEEP_STEP));
+        for (i = 0; i < DL_TASK_COUNT; i++) {
+            printf(" %s %lu/%lu", pcDeadlineTaskName((DeadlineTask_t) i),
+                   (unsigned long) sweep_misses[step][i], (unsigned long) sweep_jobs[step][i]);
+            // ExtraLoad itself may miss at 100 %, the threshold is
+            // about the rest of the task set.
+            if (sweep_misses[step][i] != 0 && i != DL_EXTRALOAD && !missed) {
+                missed = true;
+                threshold = step * LOAD_SWEEP_STEP;
+            }
+        }
+        printf("\n");
+    }
+    if (missed)
+        printf("Sweep: first deadline miss at %lu%% ExtraLoad\n", (unsigned long) threshold);
+    else
+        printf("Sweep: no deadline miss up to 100%% ExtraLoad\n");
+
+    vMemTaskDelete();
+}
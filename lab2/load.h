@@ -0,0 +1,68 @@
+/**
+ * @file load.h
+ * @brief Calibrated synthetic CPU load.
+ *
+ *        vLoadCalibrate() measures at boot how many iterations of a
+ *        fixed spin loop run per microsecond of the hardware timer
+ *        (ulTraceClockUs(): the 1 MHz timer of the RP2040, simulated
+ *        time on the host). vLoadBurnUs() then executes the iterations
+ *        for a requested CPU time instead of polling a clock: the load
+ *        has microsecond resolution, and time spent preempted is not
+ *        counted as load.
+ *
+ *        The same code runs on the Lab-Kit and in the host simulator.
+ */
+#ifndef LOAD_H
+#define LOAD_H
+
+#include <stdint.h>
+
+/* Length of one calibration run, in ulTraceClockUs() microseconds */
+#ifndef LOAD_CALIBRATION_US
+#ifdef SIM_TICKS_PER_WALL_MS
+#define LOAD_CALIBRATION_US (20000 * SIM_TICKS_PER_WALL_MS)
+#else
+#define LOAD_CALIBRATION_US 20000
+#endif
+#endif
+
+#define LOAD_CALIBRATION_RUNS   3   /* the fastest run wins */
+
+/*
+ * LOAD_SWEEP = 1: instead of the switches, ExtraLoad takes its load
+ * from vLoadSweepTask(), which steps it from 0 to 100 % and reports the
+ * deadline misses of every task per step (deadline.h) and the first
+ * step that misses one. Run it once with SMP_CORES 1 and once with
+ * SMP_CORES 2 to compare the overload threshold; build with
+ * DEGRADE_ON_MISS 0 so the load is not shed, and with the job trace
+ * (trace.h) for the response times.
+ */
+#ifndef LOAD_SWEEP
+#define LOAD_SWEEP 0
+#endif
+
+#define LOAD_SWEEP_STEP     5       /* percent */
+#define LOAD_SWEEP_DWELL    2000    /* ticks per step */
+#define LOAD_SWEEP_STEPS    (100 / LOAD_SWEEP_STEP + 1)
+
+/* Call before the scheduler starts. */
+void vLoadCalibrate(void);
+
+/* Loop iterations per microsecond, Q16. */
+uint32_t ulLoadItersPerUsQ16(void);
+
+/* Executes ulUs microseconds of CPU work. */
+void vLoadBurnUs(uint32_t ulUs);
+
+/* CPU time that gives ulPercent utilisation of a ulPeriodUs period. */
+uint32_t ulLoadUsForPercent(uint32_t ulPeriodUs, uint32_t ulPercent);
+
+/* Steps the sweep; run it above every task it measures. It prints the
+ * misses of all the steps at the end, so it only runs for a moment at
+ * each step. With SMP_CORES 2 keep it on CORE_SERVICE. */
+void vLoadSweepTask(void *args);
+
+/* Current sweep step in percent. */
+uint32_t ulLoadSweepPercent(void);
+
+#endif /* LOAD_H */
@@ -0,0 +1,119 @@
+/**
+ * @file log.c
+ * @brief Deferred logging for the periodic tasks, see log.h.
+ *
+ *        Each ring has one producer (the task owning the channel) and
+ *        one consumer (vLogDrainTask), so head and tail are each only
+ *        written by one side and no lock is needed. The barriers keep
+ *        this true when producer and drain run on different cores.
+ */
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "log.h"
+
+typedef struct {
+    uint32_t tick;
+    uint8_t  id;
+    int32_t  args[LOG_MAX_ARGS];
+} LogRecord_t;
+
+typedef struct {
+    LogRecord_t      records[LOG_RING_SIZE];
+    volatile uint32_t head;         /* written by the producer */
+    volatile uint32_t tail;         /* written by the drain task */
+    volatile uint32_t dropped;
+} LogRing_t;
+
+#define LOG_ID(name, nargs, fmt) nargs,
+static const uint8_t log_nargs[LOG_ID_COUNT] = {
+#include "log_ids.h"
+};
+#undef LOG_ID
+
+#define LOG_ID(name, nargs, fmt) fmt,
+static const char *const log_format[LOG_ID_COUNT] = {
+#include "log_ids.h"
+};
+#undef LOG_ID
+
+static LogRing_t rings[LOG_CH_COUNT];
+
+void vLogWrite(LogChannel_t channel, LogId_t id, int32_t a0, int32_t a1, int32_t a2) {
+    LogRing_t *ring = &rings[channel];
+    uint32_t head = ring->head;
+    LogRecord_t *rec;
+
+    if (head - ring->tail >= LOG_RING_SIZE) {
+        ring->dropped++;
+        return;
+    }
+    rec = &ring->records[head & (LOG_RING_SIZE - 1)];
+    rec->tick = xTaskGetTickCount();
+    rec->id = id;
+    rec->args[0] = a0;
+    rec->args[1] = a1;
+    rec->args[2] = a2;
+    __sync_synchronize();   /* publish the record before the index */
+    ring->head = head + 1;
+}
+
+uint32_t ulLogDropped(LogChannel_t channel) {
+    return rings[channel].dropped;
+}
+
+static void emit(const LogRecord_t *rec) {
+#if LOG_BINARY
+    uint8_t frame[LOG_FRAME_HEADER + 4 * LOG_MAX_ARGS];
+    uint8_t n = log_nargs[rec->id];
+    uint8_t len = 0;
+
+    frame[len++] = LOG_FRAME_SYNC;
+    frame[len++] = rec->id;
+    frame[len++] = n;
+    for (int b = 0; b < 4; b++)
+        frame[len++] = (uint8_t) (rec->tick >> (8 * b));
+    for (uint8_t i = 0; i < n; i++) {
+        for (int b = 0; b < 4; b++)
+            frame[len++] = (uint8_t) ((uint32_t) rec->args[i] >> (8 * b));
+    }
+    fwrite(frame, 1, len, stdout);
+#else
+    printf(log_format[rec->id], (int) rec->args[0], (int) rec->args[1], (int) rec->args[2]);
+#endif
+}
+
+void vLogDrainTask(void *args) {
+    TickType_t xLastWakeTime = 0;
+    const TickType_t xPeriod = (uint32_t) args;
+    uint32_t reported[LOG_CH_COUNT] = { 0 };
+    LogRecord_t rec;
+
+    while(true) {
+        for (int ch = 0; ch < LOG_CH_COUNT; ch++) {
+            LogRing_t *ring = &rings[ch];
+            uint32_t dropped;
+
+            while (ring->tail != ring->head) {
+                __sync_synchronize();
+                rec = ring->records[ring->tail & (LOG_RING_SIZE - 1)];
+                __sync_synchronize();   /* copy out before freeing the slot */
+                ring->tail = ring->tail + 1;
+                emit(&rec);
+            }
+
+            // Report lost detail once per period instead of per record.
+            dropped = ring->dropped;
+            if (dropped != reported[ch]) {
+                rec.tick = xTaskGetTickCount();
+                rec.id = LOG_DROPPED;
+                rec.args[0] = ch;
+                rec.args[1] = (int32_t) (dropped - reported[ch]);
+                emit(&rec);
+                reported[ch] = dropped;
+            }
+        }
+        fflush(stdout);
+        vTaskDelayUntil(&xLastWakeTime, xPeriod);
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * @file log.h
+ * @brief Deferred logging for the periodic tasks of the cruise control.
+ *
+ *        Instead of calling printf, a task writes a log id and up to
+ *        three raw arguments into its own single-producer ring. The
+ *        lowest priority vLogDrainTask formats the records (or, with
+ *        LOG_BINARY, sends them as binary frames for tools/logdecode)
+ *        on the serial port. A full ring drops the record and counts it.
+ */
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+
+#ifndef LOG_BINARY
+#define LOG_BINARY 0    /* 1: binary frames on the serial port */
+#endif
+
+#define LOG_RING_SIZE       32      /* records per channel, power of 2 */
+#define LOG_MAX_ARGS        3
+#define LOG_FRAME_SYNC      0xA5
+
+/* One channel (ring) per producing task. */
+typedef enum {
+    LOG_CH_CONTROL = 0,
+    LOG_CH_DISPLAY,
+    LOG_CH_GEARBOX,
+    LOG_CH_COUNT
+} LogChannel_t;
+
+#define LOG_ID(name, nargs, fmt) name,
+typedef enum {
+#include "log_ids.h"
+    LOG_ID_COUNT
+} LogId_t;
+#undef LOG_ID
+
+/* Binary frame: sync, id, nargs, tick (4 bytes), nargs * 4 bytes,
+ * all little endian. */
+#define LOG_FRAME_HEADER    7
+
+void vLogWrite(LogChannel_t channel, LogId_t id, int32_t a0, int32_t a1, int32_t a2);
+uint32_t ulLogDropped(LogChannel_t channel);
+
+/* Lowest priority task emptying all rings, args is its period in ticks. */
+void vLogDrainTask(void *args);
+
+#define LOG0(ch, id)                vLogWrite(ch, id, 0, 0, 0)
+#define LOG1(ch, id, a)             vLogWrite(ch, id, a, 0, 0)
+#define LOG2(ch, id, a, b)          vLogWrite(ch, id, a, b, 0)
+#define LOG3(ch, id, a, b, c)       vLogWrite(ch, id, a, b, c)
+
+#endif /* LOG_H */
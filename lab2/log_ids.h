@@ -0,0 +1,19 @@
+/**
+ * @file log_ids.h
+ * @brief Table of deferred log messages, shared by the target (log.c)
+ *        and the host decoder (tools/logdecode.c).
+ *
+ *        LOG_ID(name, number of arguments, printf format)
+ *        Only append at the end: the id is the position in the table
+ *        and is what goes over the serial port.
+ */
+LOG_ID(LOG_DROPPED,         2, "--- LOG: channel %d dropped %d records ---\n")
+LOG_ID(LOG_CRUISE_INIT,     1, "CRUISE_STATE: INIT, CRUISE V: %d\n")
+LOG_ID(LOG_CRUISE_ACTIVE,   2, "CRUISE_STATE: ACTIVE, CRUISE V: %d, V: %d\n")
+LOG_ID(LOG_CRUISE_EXIT,     0, "CRUISE_STATE: EXIT\n")
+LOG_ID(LOG_DISPLAY,         3, "Throttle: %d\nVelocity: %d\nPosition: %d\n")
+LOG_ID(LOG_DEADLINE_MISS,   3, "DEADLINE: task %d missed %d jobs, max lateness %d ms\n")
+LOG_ID(LOG_DEGRADE,         1, "DEGRADE: level %d\n")
+LOG_ID(LOG_GEAR_SHIFT,      2, "GEAR: %d, V: %d\n")
+LOG_ID(LOG_DISPLAY_SEG7,    3, "DISPLAY: %d frames, 7-segment %d writes, %d digits changed\n")
+LOG_ID(LOG_DISPLAY_SR,      2, "DISPLAY: shift register %d writes, %d bytes changed\n")
@@ -20,12 +20,140 @@
 #include "bsp.h"
 #include "hardware/clocks.h"
 #include "timers.h"
-
-#define GAS_STEP 2  /* Defines how much the throttle is increased if GAS_STEP is asserted */
-
-#define CRUISE_CONTROL  SW_7
-#define GAS_PEDAL       SW_6
-#define BRAKE_PEDAL     SW_5
+#include "trace.h"
+#include "log.h"
+#include "rta.h"
+#include "input.h"
+#include "state_bus.h"
+#include "vehicle.h"
+#include "controller.h"
+#include "deadline.h"
+#include "load.h"
+#include "display.h"
+#include "gearbox.h"
+#include "slope.h"
+#include "runstats.h"
+#include "mem.h"
+#include "stack_sizes.h"
+
+
+
+#ifndef LOW_POWER
+#define LOW_POWER 0 /* Pet the watchdog timer from the idle hook (tickless idle) */
+#endif
+
+#define WATCHDOG_PET_TICKS  10  /* Shortest time between two watchdog timer resets */
+
+#ifndef SMP_CORES
+#define SMP_CORES 1 /* 2: run on both RP2040 cores (configNUMBER_OF_CORES 2) */
+#endif
+
+/* Core affinity with SMP_CORES 2 */
+#define CORE_CONTROL        (1 << 0)    /* Button, Vehicle, Control, Gearbox, Slope */
+#define CORE_SERVICE        (1 << 1)    /* Display, log drain, ExtraLoad */
+
+#ifndef RTA_CHECK_AT_STARTUP
+#define RTA_CHECK_AT_STARTUP 1 /* Refuse to start an unschedulable task set */
+#endif
+
+/* Periods (ticks = ms) and priorities of the periodic tasks */
+#define WATCHDOG_PERIOD     1000
+#define WATCHDOG_PRIO       7
+#define EXTRALOAD_PERIOD    25
+#define EXTRALOAD_PRIO      6
+#define BUTTON_PERIOD       50  /* With BUTTON_IRQ: INPUT_DEBOUNCE_MS between two activations */
+#define BUTTON_PRIO         5
+#define VEHICLE_PERIOD      100
+#define VEHICLE_PRIO        4
+#define CONTROL_PERIOD      200
+#define CONTROL_PRIO        3
+#define DISPLAY_PERIOD      500
+#define DISPLAY_PRIO        2
+#define OVERLOAD_PERIOD     1000
+#define OVERLOAD_PRIO       1
+#define LOGDRAIN_PERIOD     100
+#define LOGDRAIN_PRIO       1
+#define GEARBOX_PERIOD      100
+#define GEARBOX_PRIO        VEHICLE_PRIO    /* same period as Vehicle */
+#define SLOPE_PRIO          VEHICLE_PRIO    /* one sample per Vehicle job */
+
+/* Slope estimation from the accelerometer feeds the cruise control law */
+#define SLOPE_ESTIMATE      (CONTROLLER_TERRAIN_FF == TERRAIN_FF_SLOPE)
+#define IMU_QUEUE_LENGTH    4
+
+#define RTA_BLOCKING_US     50  /* Longest kernel critical section of a lower priority task */
+
+/* Task set for the response-time analysis (rta.h), same as tools/taskset.txt.
+ * WCETs (us) are declared upper bounds, replace them by the values
+ * measured with the job trace (trace.h). ExtraLoad is declared for
+ * a 4 % setting of the load switches. */
+//  Name                      PERIOD (us)               DEADLINE (us)             WCET  BLOCKING         PRIO
+#define RTA_WATCHDOG    { "Watchdog",  WATCHDOG_PERIOD  * 1000, WATCHDOG_PERIOD  * 1000,  200, RTA_BLOCKING_US, WATCHDOG_PRIO  }
+#define RTA_EXTRALOAD   { "ExtraLoad", EXTRALOAD_PERIOD * 1000, EXTRALOAD_PERIOD * 1000, 1000, RTA_BLOCKING_US, EXTRALOAD_PRIO }
+#if BUTTON_IRQ
+#define RTA_BUTTON      { "Button",    INPUT_DEBOUNCE_MS * 1000, INPUT_DEBOUNCE_MS * 1000, 200, RTA_BLOCKING_US, BUTTON_PRIO  }
+#else
+#define RTA_BUTTON      { "Button",    BUTTON_PERIOD    * 1000, BUTTON_PERIOD    * 1000,  200, RTA_BLOCKING_US, BUTTON_PRIO    }
+#endif
+#define RTA_VEHICLE     { "Vehicle",   VEHICLE_PERIOD   * 1000, VEHICLE_PERIOD   * 1000,  300, RTA_BLOCKING_US, VEHICLE_PRIO   }
+#if BUTTON_IRQ
+/* Sporadic: Button releases Control early on every debounced input
+ * change, at most every INPUT_DEBOUNCE_MS, but the job is still due
+ * CONTROL_PERIOD after its release (vDeadlineCheck in Control). */
+#define RTA_CONTROL     { "Control",   INPUT_DEBOUNCE_MS * 1000, CONTROL_PERIOD   * 1000,  300, RTA_BLOCKING_US, CONTROL_PRIO   }
+#else
+#define RTA_CONTROL     { "Control",   CONTROL_PERIOD   * 1000, CONTROL_PERIOD   * 1000,  300, RTA_BLOCKING_US, CONTROL_PRIO   }
+#endif
+#define RTA_DISPLAY     { "Display",   DISPLAY_PERIOD   * 1000, DISPLAY_PERIOD   * 1000, 1500, RTA_BLOCKING_US, DISPLAY_PRIO   }
+#define RTA_OVERLOAD    { "Overload",  OVERLOAD_PERIOD  * 1000, OVERLOAD_PERIOD  * 1000,  200, 0,               OVERLOAD_PRIO  }
+#define RTA_LOGDRAIN    { "LogDrain",  LOGDRAIN_PERIOD  * 1000, LOGDRAIN_PERIOD  * 1000, 2000, 0,               LOGDRAIN_PRIO  }
+#define RTA_GEARBOX     { "Gearbox",   GEARBOX_PERIOD   * 1000, GEARBOX_PERIOD   * 1000,  100, RTA_BLOCKING_US, GEARBOX_PRIO   }
+#define RTA_SLOPE       { "Slope",     VEHICLE_PERIOD   * 1000, VEHICLE_PERIOD   * 1000,  100, RTA_BLOCKING_US, SLOPE_PRIO     }
+
+#if SMP_CORES > 1
+/* Partitioned: each core is analysed on its own. Watchdog and Overload
+ * are not pinned, so they are counted on both cores. */
+static const RtaTask_t xTaskSetControlCore[] = {
+    RTA_WATCHDOG, RTA_BUTTON, RTA_VEHICLE, RTA_CONTROL, RTA_OVERLOAD,
+#if GEARBOX
+    RTA_GEARBOX,
+#endif
+#if SLOPE_ESTIMATE
+    RTA_SLOPE,
+#endif
+};
+static const RtaTask_t xTaskSetServiceCore[] = {
+    RTA_WATCHDOG, RTA_EXTRALOAD, RTA_DISPLAY, RTA_OVERLOAD, RTA_LOGDRAIN,
+};
+#else
+static const RtaTask_t xTaskSet[] = {
+    RTA_WATCHDOG, RTA_EXTRALOAD, RTA_BUTTON, RTA_VEHICLE,
+    RTA_CONTROL, RTA_DISPLAY, RTA_OVERLOAD, RTA_LOGDRAIN,
+#if GEARBOX
+    RTA_GEARBOX,
+#endif
+#if SLOPE_ESTIMATE
+    RTA_SLOPE,
+#endif
+};
+#endif
+
+#if STATIC_ALLOC
+/* Stack arena (mem.h) for exactly the tasks main() creates */
+#define STACK_IF(flag, words)   ((flag) ? (words) : 0)
+
+MEM_STACK_ARENA(STACK_BUTTON_TASK + STACK_VEHICLE_TASK + STACK_CONTROL_TASK + STACK_DISPLAY_TASK
+                + STACK_WATCHDOG_TASK + STACK_OVERLOADDETECTION_TASK + STACK_EXTRALOAD_TASK
+                + STACK_LOG_DRAIN_TASK
+                + STACK_IF(!LOW_POWER, STACK_OVERLOAD_TASK)
+                + STACK_IF(RUNTIME_STATS, STACK_RUNSTATS_TASK)
+                + STACK_IF(configUSE_JOB_TRACE, STACK_TRACE_DUMP_TASK)
+                + STACK_IF(BUS_BENCH, STACK_BUS_BENCH_TASK)
+                + STACK_IF(MEMORY_MAP, STACK_MEMMAP_TASK)
+                + STACK_IF(LOAD_SWEEP, STACK_LOAD_SWEEP_TASK)
+                + STACK_IF(GEARBOX, STACK_GEARBOX_TASK)
+                + STACK_IF(SLOPE_ESTIMATE, STACK_SLOPE_TASK));
+#endif
 
 /* Definition of handles for tasks */
 TaskHandle_t    xButton_handle; /* Handle for the Button task */
@@ -35,27 +163,21 @@ TaskHandle_t    xDisplay_handle; /* Handle for the Display task */
 TaskHandle_t    xWatchdog_handle;
 TaskHandle_t    xOverloadDetection_handle;
 TaskHandle_t    xExtraLoad_handle;
+TaskHandle_t    xLogDrain_handle;
+TaskHandle_t    xGearbox_handle;
+TaskHandle_t    xLoadSweep_handle;
+TaskHandle_t    xSlope_handle;
 
-/* Definition of handles for queues */
-QueueHandle_t xQueueVelocity;
-QueueHandle_t xQueuePosition;
-QueueHandle_t xQueueThrottle;
-QueueHandle_t xQueueCruiseControl;
-QueueHandle_t xQueueGasPedal;
-QueueHandle_t xQueueBrakePedal;
-QueueHandle_t xQueueOverloadDetected;
-QueueHandle_t xQueueOverloadState;
-QueueHandle_t xQueueSwitches;
+/* Task state is exchanged through the shared state bus (state_bus.h) */
 
 TimerHandle_t xWatchdogTimer;
 
-// Cruise control FSM machine.
-typedef enum {
-    IDLE = 0,
-    CRUISE_INIT = 1,
-    CRUISE_ACTIVE = 2,
-    CRUISE_EXIT = 3 
-} STATE;
+#if SLOPE_ESTIMATE
+/* Accelerometer samples from the Vehicle task to the Slope task */
+QueueHandle_t xImuQueue;
+#endif
+
+/* The cruise control FSM (STATE) is in controller.c */
 
  /**
   * =======================================================================
@@ -68,6 +190,9 @@ typedef enum {
   *     Performs a single iteration of while loop that scans buttons,
   *     updates GAS, BRAKE, and CRUISE sets LEDS and ovewrites into queue.
   *     Delays until next period.
+  *
+  *     With BUTTON_IRQ the task instead sleeps until a debounced input
+  *     change (see input.h) and then wakes the Control task at once.
   */
 void vButtonTask(void *args) {
 
@@ -87,16 +212,33 @@ void vButtonTask(void *args) {
     
     // holds flags for switches SW10-SW17 in order.
     uint8_t switch_pins = 0;
+    uint16_t inputs;
+#if INPUT_BENCH
+    uint32_t start_us;
+#endif
+#if BUTTON_IRQ
+    (void) xPeriod;         // event driven, no period
+    (void) xLastWakeTime;
+#endif
 
     /* Busy wait IO for Button input */
     /* Directly set LEDs from Button Task */
     /* Delay until next period */
     while(true) {
 
-        // PULL_UP Buttons we need to take inverse.
-        value_gas_pedal      = !BSP_GetInput(GAS_PEDAL);
-        value_brake_pedal    = !BSP_GetInput(BRAKE_PEDAL);
-        value_cruise_control = !BSP_GetInput(CRUISE_CONTROL);
+        // One port read for all pedals and switches (already inverted
+        // for the PULL_UP buttons).
+#if BUTTON_IRQ
+        inputs = usInputWait();
+#else
+        inputs = usInputRead();
+#endif
+#if INPUT_BENCH
+        start_us = ulTraceClockUs();
+#endif
+        value_gas_pedal      = (inputs & INPUT_GAS) != 0;
+        value_brake_pedal    = (inputs & INPUT_BRAKE) != 0;
+        value_cruise_control = (inputs & INPUT_CRUISE) != 0;
 
         // Is this suppose to be done here directly? Or do we have 
         // To wait for command from controller to light them?
@@ -107,103 +249,47 @@ void vButtonTask(void *args) {
         //BSP_SetLED(LED_YELLOW,  value_cruise_control);
         
         /* READ SWITCHES INPUT */
-        switch_pins = 0;
-        switch_pins = ( (BSP_GetInput(SW_10) << 7)
-                      | (BSP_GetInput(SW_11) << 6)
-                      | (BSP_GetInput(SW_12) << 5)
-                      | (BSP_GetInput(SW_13) << 4)
-                      | (BSP_GetInput(SW_14) << 3)
-                      | (BSP_GetInput(SW_15) << 2)
-                      | (BSP_GetInput(SW_16) << 1)
-                      | (BSP_GetInput(SW_17)));
-
-        xQueueOverwrite(xQueueGasPedal,     &value_gas_pedal);
-        xQueueOverwrite(xQueueBrakePedal,   &value_brake_pedal);
-        xQueueOverwrite(xQueueCruiseControl,&value_cruise_control);
-        xQueueOverwrite(xQueueSwitches,     &switch_pins);
-
-        vTaskDelayUntil(&xLastWakeTime, xPeriod);
+        switch_pins = inputs & INPUT_SWITCHES;
+
+        vBusPublishPedals(value_gas_pedal, value_brake_pedal, value_cruise_control, switch_pins);
+
+#if INPUT_BENCH
+        vInputBenchButton(start_us);
+#endif
+#if BUTTON_IRQ
+        // Control reacts now instead of at its next release.
+        xTaskNotifyGive(xControl_handle);
+#else
+        vDeadlineDelayUntil(DL_BUTTON, &xLastWakeTime, xPeriod);
+#endif
     }
 }
 
 
-void cruise_control_FSM(
-    uint8_t *p_state, 
-    bool *p_cruise_control_button, 
-    bool gas_pedal, 
-    bool brake_pedal, 
-    uint16_t velocity,
-    uint16_t *p_cruise_velocity,
-    uint16_t *p_throttle
-) {
-    switch (*p_state)
+/**
+ * @brief LED and log output of the cruise control FSM for the state
+ *        cruise_update() started the period in.
+ */
+void cruise_control_report(uint8_t state, const CruiseControl_t *cc, uint16_t velocity) {
+    switch (state)
     {
         case IDLE: {
-            
             // YELLOW LED is off while cruise in inactive.
             BSP_SetLED(LED_YELLOW, 0);
-            if(*p_cruise_control_button == 1)
-                *p_state = CRUISE_INIT;
         } break;
         case CRUISE_INIT: {
-            printf("CRUISE_STATE: INIT\n");
-            // Wait for button to be unpressed. This state also sets the
-            // desired cruise velocity held by the CRUISE_ACTIVE state.
-            if(*p_cruise_control_button == 0) {
-                *p_state = CRUISE_ACTIVE;
-                *p_cruise_velocity = velocity;
-            }
-            printf("INIT: CRUISE V: %d\n", *p_cruise_velocity);
+            LOG1(LOG_CH_CONTROL, LOG_CRUISE_INIT, cc->cruise_velocity);
         } break;
         case CRUISE_ACTIVE: {
-            printf("CRUISE_STATE: ACTIVE\n");
-
             // Yellow LED turned on while CRUISE is active.
             BSP_SetLED(LED_YELLOW, 1);
-
-            // While in CRUISE if conditions no longer hold go directly to idle.
-            if(gas_pedal || brake_pedal || (velocity < 25)) {
-                *p_state = IDLE;
-            }
-
-            // If cruise button is pressed again go to cruise exit that works the 
-            // same as cruiseinit (i.e. smooth button pressing)
-            if(*p_cruise_control_button == 1) {
-                *p_state = CRUISE_EXIT;
-            }
-            
-            /* CRUISE CONTROL ALGORITHM */
-            // Idea is based on this equation but throttle cannot be negative...
-            // throttle += 8 * (cruise_velocity - velocity);
-            // Retardation varies between approx. (-15, 17) 
-            //so taking the average we get constant 8.
-            // Holds +/- 4 (V) for lower velocities, as V goes higher (>70) it starts
-            // to be more wavy amplified.
-
-            printf("CRUISE V: %d, V: %d\n", *p_cruise_velocity, velocity);
-
-            // Current V is above desired V.
-            if(*p_cruise_velocity < velocity) {
-                    *p_throttle = 0;
-            }
-            
-            // Current V is below desired V
-            if(*p_cruise_velocity > velocity) {
-                *p_throttle += 8;
-                if(*p_throttle > 80) {
-                    *p_throttle = 80;
-                }
-            }
+            LOG2(LOG_CH_CONTROL, LOG_CRUISE_ACTIVE, cc->cruise_velocity, velocity);
         } break;
         case CRUISE_EXIT: {
-            printf("CRUISE_STATE: EXIT\n");
-            if(*p_cruise_control_button == 0)
-                *p_state = IDLE;
-        } break;
-        
-        default: {
-            *p_state = IDLE;
+            LOG0(LOG_CH_CONTROL, LOG_CRUISE_EXIT);
         } break;
+        default:
+            break;
     }
 }
 
@@ -226,6 +312,9 @@ void cruise_control_FSM(
  *      When CRUISE is true velocity needs to be held (+-4 m/s) within
  *      cruise_velocity. 
  *      If velocity is less then increase, if less, decrease.
+ *
+ *      With BUTTON_IRQ an input change notified by the Button task
+ *      releases the task early and restarts its period.
  */
 void vControlTask(void *args) {
 
@@ -235,57 +324,80 @@ void vControlTask(void *args) {
     //uint16_t throttle = 80;
     uint16_t throttle = 0;
     uint16_t velocity = 0;
-    uint16_t cruise_velocity;
+    uint16_t position = 0;
 
     //bool cruise_control_button;
-    bool cruise_control;
-    bool cruise_control_button;
-    bool gas_pedal;
-    bool brake_pedal;
+    bool cruise_control_button = false;
+    bool gas_pedal = false;
+    bool brake_pedal = false;
+    CruiseState_t bus;
+    CruiseControl_t cruise;
+    uint8_t cruise_state;
+#if BUTTON_IRQ
+    TickType_t xNow;
+    TickType_t xLeft;
+    TickType_t xLastUpdate = 0;
+#endif
     
     // initialize in state IDLE.
-    uint8_t cruise_state = IDLE;
+    cruise_init(&cruise);
 
     // By aligning the else if statements in order of BRAKE, GAS, CRUISE
     // we automatically place operations in assigned priority.
     while(true) {
 
-        cruise_control_FSM(
-            &cruise_state, 
-            &cruise_control_button, 
-            gas_pedal, 
-            brake_pedal, 
-            velocity, 
-            &cruise_velocity,
-            &throttle);
-
-        if (gas_pedal) {
-            throttle += GAS_STEP; 
-            if (throttle > 80) {
-                throttle = 80;
-            }
-        }
-        else 
-        {
-            // Case Nothing: (same as braking)
-            // If we brake cruise_state goes to IDLE.
-            if(cruise_state == IDLE) {
-                throttle = 0;
-            }
-
-            // Should we be outside where cruise_state != IDLE
-            // then we should not do anything with throttle here
-            // it will be handled in the cruise_control.
-        }
-
-        xQueuePeek(xQueueCruiseControl, &cruise_control_button, ( TickType_t ) 0);
-        xQueuePeek(xQueueGasPedal, &gas_pedal, ( TickType_t ) 0);   
-        xQueuePeek(xQueueVelocity, &velocity, ( TickType_t ) 0);     
-        xQueuePeek(xQueueBrakePedal, &brake_pedal, ( TickType_t ) 0);
-        
-        xQueueOverwrite(xQueueThrottle, &throttle);
-
-        vTaskDelayUntil(&xLastWakeTime, xPeriod);
+        // Read the inputs first, so that a release caused by an input
+        // change acts on that change and not on last period's values.
+        // One snapshot: gas, brake and velocity are from the same instant.
+        vBusRead(&bus);
+        cruise_control_button = bus.cruise_control;
+        gas_pedal   = bus.gas_pedal;
+        velocity    = bus.velocity;
+        position    = bus.position;
+        brake_pedal = bus.brake_pedal;
+#if INPUT_BENCH
+        vInputBenchConsumed();
+#endif
+
+        // Mode logic and control law (controller.c), shared with the
+        // host plant simulator. The law works in drive; the gain of
+        // the engaged gear turns it into throttle (gearbox.h).
+        cruise.drive_gain = gearbox_gain(bus.gear, velocity);
+#if BUTTON_IRQ
+        // An early release is less than a period after the last update;
+        // the PI(D) integrates only over the time that passed.
+        xNow = xTaskGetTickCount();
+        cruise.elapsed = (uint16_t) (((xNow - xLastUpdate) * ELAPSED_ONE + xPeriod / 2) / xPeriod);
+        if (cruise.elapsed > 4 * ELAPSED_ONE)
+            cruise.elapsed = 4 * ELAPSED_ONE;
+        xLastUpdate = xNow;
+#endif
+        cruise.slope = bus.slope;
+        cruise_state = cruise.state;
+        throttle = cruise_update(&cruise, cruise_control_button,
+                                 gas_pedal, brake_pedal, velocity, position);
+        cruise_control_report(cruise_state, &cruise, velocity);
+
+        vBusPublishThrottle(throttle);
+
+        // Degrade (or recover) according to the misses seen so far.
+        xDeadlineUpdate();
+
+#if BUTTON_IRQ
+        // Sleep until the next release or until Button reports an
+        // input change, whichever comes first.
+        vDeadlineCheck(DL_CONTROL, xLastWakeTime + xPeriod);
+        xNow = xTaskGetTickCount();
+        xLeft = xLastWakeTime + xPeriod - xNow;
+        if ((int32_t) xLeft < 0)
+            xLeft = 0;
+        if (ulTaskNotifyTake(pdTRUE, xLeft) != 0)
+            xLastWakeTime = xTaskGetTickCount();
+        else
+            xLastWakeTime += xPeriod;
+#else
+        vDeadlineDelayUntil(DL_CONTROL, &xLastWakeTime, xPeriod);
+#endif
     }
 }
 
@@ -303,12 +415,13 @@ void vWatchdogTask(void *args) {
     
     const TickType_t xPeriod = (uint32_t) args;
     TickType_t xLastWakeTime = 0;
-    bool overloadState = false;
+    CruiseState_t bus;
     bool OK;
 
     while(true) {
 
-        xQueuePeek(xQueueOverloadDetected, &OK, ( TickType_t ) 0);
+        vBusRead(&bus);
+        OK = bus.overload_ok;
 
         if(OK == true) {
             // Do nothing. 
@@ -317,8 +430,7 @@ void vWatchdogTask(void *args) {
 
             // Also reset OK signal back to 0.
             // Otherwise it will remain 1 even if overload detection sets it.
-            OK = false;
-            xQueueOverwrite(xQueueOverloadDetected, &OK);
+            vBusSetOverloadOk(false);
         } 
         else {
             // OK was never set to 1 meaning overload.
@@ -326,11 +438,13 @@ void vWatchdogTask(void *args) {
             BSP_SetLED(LED_GREEN, 1);
             BSP_SetLED(LED_YELLOW, 1);
             BSP_SetLED(LED_RED, 1);
-            overloadState = true;
-            xQueueOverwrite(xQueueOverloadState, &overloadState);
+            vBusSetOverloadState(true);
+
+            // Control may be starved as well: shed what can be shed.
+            vDeadlineEscalate();
         }
 
-        vTaskDelayUntil(&xLastWakeTime, xPeriod);
+        vDeadlineDelayUntil(DL_WATCHDOG, &xLastWakeTime, xPeriod);
     }
 }
 
@@ -346,26 +460,24 @@ void vOverloadDetectionTask(void *args) {
 
     const TickType_t xPeriod = (uint32_t) args;
     TickType_t xLastWakeTime = 0;
-    bool OK, overloadState;
+    CruiseState_t bus;
 
     while(true) {
         // Function has been called so set OK signal.
-        OK = true;
-        xQueueOverwrite(xQueueOverloadDetected, &OK);
+        vBusSetOverloadOk(true);
         printf("OverloadTask has been called.\n");
 
-        xQueuePeek(xQueueOverloadState, &overloadState, ( TickType_t ) 0);
-        if (overloadState == true) {
+        vBusRead(&bus);
+        if (bus.overload_state == true) {
             // Watchdog overload alarm occured
             // Now deactivate alarm...
             BSP_SetLED(LED_GREEN, 0);
             BSP_SetLED(LED_YELLOW, 0);
             BSP_SetLED(LED_RED, 0);
-            overloadState = false;
-            xQueueOverwrite(xQueueOverloadState, &overloadState);
+            vBusSetOverloadState(false);
         }
        
-        vTaskDelayUntil(&xLastWakeTime, xPeriod);
+        vDeadlineDelayUntil(DL_OVERLOAD, &xLastWakeTime, xPeriod);
     }
 }
 
@@ -380,25 +492,27 @@ void vExtraLoadTask(void *args) {
         // We cannot expect go get switch input from "button" task
         // because once overload occurs "button" task cannot run
         // and so we can never stop the overload...
-        load = 0;
-        load = ( (BSP_GetInput(SW_10) << 7)
-               | (BSP_GetInput(SW_11) << 6)
-                | (BSP_GetInput(SW_12) << 5)
-                | (BSP_GetInput(SW_13) << 4)
-                | (BSP_GetInput(SW_14) << 3)
-                | (BSP_GetInput(SW_15) << 2)
-                | (BSP_GetInput(SW_16) << 1)
-                | (BSP_GetInput(SW_17)));
+#if LOAD_SWEEP
+        load = ulLoadSweepPercent();
+#else
+        load = usInputRead() & INPUT_SWITCHES;
+#if GEARBOX
+        load &= ~GEAR_SELECT_MASK;      // SW_10..SW_12 select the gear
+#endif
+#endif
 
         
-        TickType_t start = xTaskGetTickCount();
-        TickType_t ticks = pdMS_TO_TICKS(load / 10);
-        //printf("Extra Load: %d\n", load / 10);
-
-        // Busy Wait for amount (load / 10) (ms).
-        // Wait by converting (ms) to ticks and loop.
-        while((xTaskGetTickCount() - start) < ticks);
-        vTaskDelayUntil(&xLastWakeTime, xPeriod);
+        // The switches give the utilisation in percent of the period
+        // (ticks are ms), burnt as calibrated CPU work (load.h).
+        uint32_t us = ulLoadUsForPercent(xPeriod * 1000u, load);
+        //printf("Extra Load: %d us\n", us);
+
+        // Shed while the task set is missing deadlines (deadline.h).
+        if (xDeadlineLevel() >= DEGRADE_SHED_LOAD)
+            us = 0;
+
+        vLoadBurnUs(us);
+        vDeadlineDelayUntil(DL_EXTRALOAD, &xLastWakeTime, xPeriod);
     }
 }
 
@@ -406,106 +520,65 @@ void vExtraLoadTask(void *args) {
 // Enters OVERLOADSTATE and turns on LEDs
 void vTimerCallback(TimerHandle_t timer) {
 
-    bool overloadState = true;
-
     printf("--- SYSTEM OVERLOAD ---\n");
     BSP_SetLED(LED_GREEN, 1);
     BSP_SetLED(LED_YELLOW, 1);
     BSP_SetLED(LED_RED, 1);
-    xQueueOverwrite(xQueueOverloadState, &overloadState);
+    vBusSetOverloadState(true);
     
 }
 
+#if LOW_POWER
+// Resets the Watchdog Timer back to 1000 from the idle hook: the
+// timer only expires if the idle task did not run for 1000 ms, and
+// no task has to poll, so the kernel can stop the tick and sleep
+// (configUSE_TICKLESS_IDLE). The hook must not block.
+void vApplicationIdleHook(void) {
+    static TickType_t xLastPet;
+    TickType_t xNow = xTaskGetTickCount();
+    CruiseState_t bus;
+
+    if (xNow - xLastPet < WATCHDOG_PET_TICKS)
+        return;
+    xLastPet = xNow;
+    xTimerReset(xWatchdogTimer, 0);
+
+    // Watchdog overload alarm occured. Now deactivate alarm...
+    vBusRead(&bus);
+    if (bus.overload_state == true) {
+        BSP_SetLED(LED_GREEN, 0);
+        BSP_SetLED(LED_YELLOW, 0);
+        BSP_SetLED(LED_RED, 0);
+        vBusSetOverloadState(false);
+    }
+}
+#else
 // Resets the Watchdog Timer back to 1000.
 // The task is made into a background task that always runs if nothing
 // else is available by simply making it a straight inifinite loop.
 // Because when there are higher prio tasks available scheduler will preempt.
 void vOverloadDetectionTimer(void *args) {
-    bool overloadState;
+    CruiseState_t bus;
 
     while(true) {
         //printf("RESET THE WATCHDOG TIMER.\n");
         xTimerReset(xWatchdogTimer, portMAX_DELAY);
 
         // Watchdog overload alarm occured. Now deactivate alarm...
-        xQueuePeek(xQueueOverloadState, &overloadState, ( TickType_t ) 0);
-        if (overloadState == true) {
+        vBusRead(&bus);
+        if (bus.overload_state == true) {
             BSP_SetLED(LED_GREEN, 0);
             BSP_SetLED(LED_YELLOW, 0);
             BSP_SetLED(LED_RED, 0);
-            overloadState = false;
-            xQueueOverwrite(xQueueOverloadState, &overloadState);
+            vBusSetOverloadState(false);
         }
 
-        vTaskDelay(10); // Small delay to not completely spam...
+        vTaskDelay(WATCHDOG_PET_TICKS); // Small delay to not completely spam...
     }
 }
+#endif
 
 
-/**
- * @brief The function returns the new position depending on the input parameters.
- * 
- * ==> DO NOT CHANGE THIS FUNCTION !!!
- * 
- * @param position 
- * @param velocity 
- * @param acceleration 
- * @param time_interval 
- * @return 
- */
-uint16_t adjust_position(uint16_t position, int16_t velocity,
-                         int8_t acceleration, uint16_t time_interval)
-{
-  int16_t new_position = position + velocity * time_interval / 1000
-    + acceleration / 2  * (time_interval / 1000) * (time_interval / 1000);
-
-  if (new_position > 24000) {
-    new_position -= 24000;
-  } else if (new_position < 0){
-    new_position += 24000;
-  }
-
-  return new_position;
-}
-
-
-/**
- * @brief The function returns the new velocity depending on the input parameters.
- * 
- * ==> DO NOT CHANGE THIS FUNCTION !!! 
- *
- * @param velocity 
- * @param acceleration 
- * @param brake_pedal 
- * @param time_interval 
- * @return 
- */
-int16_t adjust_velocity(int16_t velocity, int8_t acceleration,  
-		       bool brake_pedal, uint16_t time_interval)
-{
-  int16_t new_velocity;
-  uint8_t brake_retardation = 50;
-
-  if (brake_pedal == false) {
-    // Had to manually change here because it was casted to float after division...
-    new_velocity = velocity  + ((float) (acceleration * time_interval) / 1000);
-    //printf("nv: %d, v: %d, a: %d, time_int: %d\n", new_velocity, velocity, acceleration, time_interval);
-    if (new_velocity <= 0) {
-        new_velocity = 0;
-    }
-  } 
-  else { 
-    if ((float) (brake_retardation * time_interval) / 1000 > velocity) {
-       new_velocity = 0;
-    }
-    else {
-      new_velocity = velocity - (float) brake_retardation * time_interval / 1000;
-    }
-  } 
-
-  return new_velocity;
-}
-
 /**
  * @brief The vehicle task continuously calculates the velocity of the vehicle 
  *
@@ -522,45 +595,108 @@ void vVehicleTask(void *args) {
     //=========================================
     // Changed to signed int8_t.
     int8_t acceleration;  /* Value between 40 and -20 (4.0 m/s^2 and -2.0 m/s^2) */
-    uint8_t retardation;   /* Value between 20 and -10 (2.0 m/s^2 and -1.0 m/s^2) */
     uint16_t position = 0; /* Value between 0 and 24000 (0.0 m and 2400.0 m)  */
     uint16_t velocity = 0; /* Value between -200 and 700 (-20.0 m/s amd 70.0 m/s) */
-    uint16_t wind_factor;   /* Value between -10 and 20 (2.0 m/s^2 and -1.0 m/s^2) */
+    CruiseState_t bus;
+#if SLOPE_ESTIMATE
+    uint16_t imu_noise = 1;
+    uint16_t last_velocity;
+    ImuSample_t sample;
+#endif
 
     for (;;) {
-        xQueuePeek(xQueueThrottle, &throttle, ( TickType_t ) 0);
-        xQueuePeek(xQueueBrakePedal, &brake_pedal, ( TickType_t ) 0);
-
-        /* Retardation : Factor of Terrain and Wind Resistance */
-        if (velocity > 0)
-	        wind_factor = velocity * velocity / 10000 + 1;
-        else 
-	        wind_factor = (-1) * velocity * velocity / 10000 + 1;
-
-        if (position < 4000) 
-            retardation = wind_factor; // even ground
-        else if (position < 8000)
-            retardation = wind_factor + 8; // traveling uphill
-        else if (position < 12000)
-            retardation = wind_factor + 16; // traveling steep uphill
-        else if (position < 16000)
-            retardation = wind_factor; // even ground
-        else if (position < 20000)
-            retardation = wind_factor - 8; //traveling downhill
-        else
-            retardation = wind_factor - 16 ; // traveling steep downhill
-
-        acceleration = throttle / 2 - retardation;	  
-        // printf("acceleration %d, retard: %d\n", acceleration, retardation);
+        vBusRead(&bus);
+        throttle = bus.throttle;
+        brake_pedal = bus.brake_pedal;
+#if SLOPE_ESTIMATE
+        last_velocity = velocity;
+#endif
+
+        /* Retardation : Factor of Terrain and Wind Resistance (vehicle.c),
+         * throttle through the engaged gear (gearbox.c) */
+        acceleration = gearbox_acceleration(throttle, bus.gear, position, velocity);
+        // printf("acceleration %d\n", acceleration);
         position = adjust_position(position, velocity, acceleration, xPeriod); 
         velocity = adjust_velocity(velocity, acceleration, brake_pedal, xPeriod);         
 
  
-        xQueueOverwrite(xQueueVelocity, &velocity);
-        xQueueOverwrite(xQueuePosition, &position); 
-        vTaskDelayUntil(&xLastWakeTime, xPeriod);   /* Wait for the next release. */
+        vBusPublishVehicle(velocity, position);
+#if SLOPE_ESTIMATE
+        // What the accelerometer on the car reads over this step; a
+        // full queue drops the sample rather than delaying the plant.
+        sample = imu_sample(acceleration, gearbox_thrust(throttle, bus.gear, last_velocity),
+                            brake_pedal, last_velocity, velocity, &imu_noise);
+        xQueueSend(xImuQueue, &sample, 0);
+#endif
+        vDeadlineDelayUntil(DL_VEHICLE, &xLastWakeTime, xPeriod);   /* Wait for the next release. */
+    }
+}
+
+#if SLOPE_ESTIMATE
+/**
+ * =======================================================================
+ * vSlopeTask(void *args):
+ *      @brief Conditional task: filters every accelerometer sample of
+ *             the Vehicle task into a slope estimate (slope.h) and
+ *             publishes it for the feed-forward of the Control task.
+ *      @param args corresponds to the sample period (100ms).
+ */
+void vSlopeTask(void *args) {
+    const TickType_t xPeriod = (uint32_t) args;
+    SlopeFilter_t filter;
+    ImuSample_t sample;
+    TickType_t xRelease;
+
+    slope_init(&filter);
+
+    for (;;) {
+        xQueueReceive(xImuQueue, &sample, portMAX_DELAY);
+        xRelease = xTaskGetTickCount();
+
+        vBusPublishSlope(slope_update(&filter, &sample));
+
+        // Sporadic: done before the next sample is due.
+        vDeadlineCheck(DL_SLOPE, xRelease + xPeriod);
     }
 }
+#endif
+
+#if GEARBOX
+/**
+ * =======================================================================
+ * vGearboxTask(void *args):
+ *      @brief Conditional task: selects the gear. SW_10..SW_12 give a
+ *             gear (1-5) to hold, 0 follows the automatic shift points
+ *             of gearbox.c. The Vehicle task applies the gear's torque,
+ *             Control its gain and Display shows it.
+ *      @param args corresponds to period of task (100ms).
+ */
+void vGearboxTask(void *args) {
+    TickType_t xLastWakeTime = 0;
+    const TickType_t xPeriod = (uint32_t) args;
+    CruiseState_t bus;
+    Gearbox_t gearbox;
+    uint8_t selector;
+    uint8_t gear;
+
+    gearbox_init(&gearbox);
+    vBusPublishGear(gearbox.gear);
+
+    for (;;) {
+        vBusRead(&bus);
+        selector = (bus.switches & GEAR_SELECT_MASK) >> GEAR_SELECT_SHIFT;
+
+        // One table lookup; at most one gear per period.
+        gear = gearbox.gear;
+        if (gearbox_select(&gearbox, selector, bus.velocity) != gear) {
+            vBusPublishGear(gearbox.gear);
+            LOG2(LOG_CH_GEARBOX, LOG_GEAR_SHIFT, gearbox.gear, bus.velocity);
+        }
+
+        vDeadlineDelayUntil(DL_GEARBOX, &xLastWakeTime, xPeriod);
+    }
+}
+#endif
 
 /**
  * =======================================================================
@@ -577,42 +713,36 @@ void vDisplayTask(void *args) {
     uint16_t velocity; 
     uint16_t throttle;  
     uint16_t position;
-    char display7Seg[5]; // 4 chars + null byte
-    uint32_t LED24 = 0;
-    uint8_t *p_LED24 = (uint8_t*)&LED24;
-    uint8_t step;
+    CruiseState_t bus;
+    DisplayStats_t stats;
 
     // Initially clear and set brightness (0-15)
-    BSP_7SegClear();
-    BSP_7SegBrightness(7);
+    vDisplayInit();
 
     for (;;) {
-        xQueuePeek(xQueueVelocity, &velocity, ( TickType_t ) 0);
-        xQueuePeek(xQueuePosition, &position, ( TickType_t ) 0);
-        xQueuePeek(xQueueThrottle, &throttle, ( TickType_t ) 0);
-
-        printf("Throttle: %d\n", throttle);
-        printf("Velocity: %d\n", velocity);
-        printf("Position: %d\n", position);
-
-        // we shift the 1 depending on how many steps in mod 24 
-        // that vehicle (position) has taken.
-        // p_LED24 actually points to uint32_t but we only use 
-        // the first 24 bits. So it behaves like uint8_t LED24[3].
-        step = (position / 1000) % 24;        
-        LED24 = 0x00000001 << step;
-        BSP_ShiftRegWriteAll(p_LED24);
-
-        // THROTTLE is placed in U14, U15 and VELOCITY in U16, U17
-        // display7Seg = ((throttle << 16) | velocity);
-        //display7Seg[0] = '0';
-        //display7Seg[1] = '1';
-        //display7Seg[2] = '2';
-        //display7Seg[3] = '3';
-        sprintf(display7Seg, "%02d%02d", throttle, velocity, sizeof(display7Seg));
-        BSP_7SegDispString(display7Seg);
-        
-        vTaskDelayUntil(&xLastWakeTime, xPeriod);   /* Wait for the next release. */
+        vBusRead(&bus);
+        velocity = bus.velocity;
+        position = bus.position;
+        throttle = bus.throttle;
+
+        // Deferred to vLogDrainTask, printf here dominated the task's WCET.
+        LOG3(LOG_CH_DISPLAY, LOG_DISPLAY, throttle, velocity, position);
+
+        // Throttle and velocity on the 7-segment display, the position
+        // on the 24 LEDs; only what changed is written (display.h).
+        vDisplayUpdate(throttle, velocity, position, bus.gear);
+        vDisplayStats(&stats);
+        if (stats.frames % DISPLAY_STATS_FRAMES == 0) {
+            LOG3(LOG_CH_DISPLAY, LOG_DISPLAY_SEG7, stats.frames, stats.seg7_writes,
+                 stats.digits_changed);
+            LOG2(LOG_CH_DISPLAY, LOG_DISPLAY_SR, stats.sr_writes, stats.bytes_changed);
+        }
+
+        // Lower rate while the task set is degraded (deadline.h).
+        if (xDeadlineLevel() >= DEGRADE_SLOW_DISPLAY)
+            vDeadlineDelayUntil(DL_DISPLAY, &xLastWakeTime, xPeriod * DISPLAY_SLOWDOWN);
+        else
+            vDeadlineDelayUntil(DL_DISPLAY, &xLastWakeTime, xPeriod);
     }
 }
 
@@ -629,33 +759,123 @@ int main()
 {
     BSP_Init();  /* Initialize all components on the ES Lab-Kit. */
 
+    /* Iterations per us of the ExtraLoad spin loop, before any task runs */
+    vLoadCalibrate();
+
+#if RTA_CHECK_AT_STARTUP
+    // Analytical counterpart of the watchdog: an unschedulable
+    // configuration never reaches the scheduler.
+#if SMP_CORES > 1
+    bool xControlCoreOk = xRtaCheck(xTaskSetControlCore,
+            sizeof(xTaskSetControlCore) / sizeof(xTaskSetControlCore[0]), true);
+    bool xServiceCoreOk = xRtaCheck(xTaskSetServiceCore,
+            sizeof(xTaskSetServiceCore) / sizeof(xTaskSetServiceCore[0]), true);
+
+    if (!xControlCoreOk || !xServiceCoreOk) {
+#else
+    if (!xRtaCheck(xTaskSet, sizeof(xTaskSet) / sizeof(xTaskSet[0]), true)) {
+#endif
+        printf("--- TASK SET NOT SCHEDULABLE ---\n");
+        BSP_SetLED(LED_GREEN, 1);
+        BSP_SetLED(LED_YELLOW, 1);
+        BSP_SetLED(LED_RED, 1);
+        while (true) {
+            sleep_ms(1000);
+        }
+    }
+#endif
+
     // ================================================================================
     //          Task            Name        STACK   PERIOD      PRIO        POINTER
-    xTaskCreate(vButtonTask, "Button Task",   512, (void*) 50,      5, &xButton_handle);
-    xTaskCreate(vVehicleTask, "Vehicle Task", 512, (void*) 100,     4, &xVehicle_handle); 
-    xTaskCreate(vControlTask, "Control Task", 512, (void*) 200,     3, &xControl_handle);
-    xTaskCreate(vDisplayTask, "Display Task", 512, (void*) 500,     2, &xDisplay_handle); 
-
-    xTaskCreate(vWatchdogTask, "Watchdog Task", 512, (void*) 1000,  7, &xWatchdog_handle);
-    xTaskCreate(vOverloadDetectionTask, "OverloadDetection Task",  512, (void*) 1000,  1, &xOverloadDetection_handle);
-    xTaskCreate(vExtraLoadTask, "ExtraLoad Task",  512, (void*) 25,  6, &xExtraLoad_handle);
+    xMemTaskCreate(vButtonTask, "Button Task",   STACK_BUTTON_TASK, (void*) BUTTON_PERIOD,    BUTTON_PRIO,    &xButton_handle);
+    xMemTaskCreate(vVehicleTask, "Vehicle Task", STACK_VEHICLE_TASK, (void*) VEHICLE_PERIOD,   VEHICLE_PRIO,   &xVehicle_handle); 
+    xMemTaskCreate(vControlTask, "Control Task", STACK_CONTROL_TASK, (void*) CONTROL_PERIOD,   CONTROL_PRIO,   &xControl_handle);
+    xMemTaskCreate(vDisplayTask, "Display Task", STACK_DISPLAY_TASK, (void*) DISPLAY_PERIOD,   DISPLAY_PRIO,   &xDisplay_handle); 
+
+    xMemTaskCreate(vWatchdogTask, "Watchdog Task", STACK_WATCHDOG_TASK, (void*) WATCHDOG_PERIOD,  WATCHDOG_PRIO,  &xWatchdog_handle);
+    xMemTaskCreate(vOverloadDetectionTask, "OverloadDetection Task",  STACK_OVERLOADDETECTION_TASK, (void*) OVERLOAD_PERIOD,  OVERLOAD_PRIO,  &xOverloadDetection_handle);
+    xMemTaskCreate(vExtraLoadTask, "ExtraLoad Task",  STACK_EXTRALOAD_TASK, (void*) EXTRALOAD_PERIOD, EXTRALOAD_PRIO, &xExtraLoad_handle);
     
-    /* For Watchdog Timer (conditional A)*/
-    xTaskCreate(vOverloadDetectionTimer, "Overload Task",  512, (void*) 1000,  1, &xOverloadDetection_handle);
-
-    /* Create the message queues */
-    xQueueCruiseControl = xQueueCreate( 1, sizeof(bool));
-    xQueueGasPedal      = xQueueCreate( 1, sizeof(bool));
-    xQueueBrakePedal    = xQueueCreate( 1, sizeof(bool));
-    xQueueVelocity      = xQueueCreate( 1, sizeof(uint16_t));
-    xQueuePosition      = xQueueCreate( 1, sizeof(uint16_t));
-    xQueueThrottle      = xQueueCreate( 1, sizeof(uint16_t));
-
-    xQueueOverloadDetected = xQueueCreate( 1, sizeof(bool));
-    xQueueOverloadState = xQueueCreate( 1, sizeof(bool));
-    xQueueSwitches      = xQueueCreate( 1, sizeof(uint8_t));
-
-    xWatchdogTimer = xTimerCreate("Watchdog Timer", pdMS_TO_TICKS(1000), pdFALSE, 0, vTimerCallback);
+#if !LOW_POWER
+    /* For Watchdog Timer (conditional A), with LOW_POWER the idle hook resets it */
+    xMemTaskCreate(vOverloadDetectionTimer, "Overload Task",  STACK_OVERLOAD_TASK, (void*) 1000,  1, &xOverloadDetection_handle);
+#endif
+
+#if GEARBOX
+    /* Conditional task: gear selection and shift points (gearbox.h) */
+    xMemTaskCreate(vGearboxTask, "Gearbox Task", STACK_GEARBOX_TASK, (void*) GEARBOX_PERIOD, GEARBOX_PRIO, &xGearbox_handle);
+#endif
+
+#if SLOPE_ESTIMATE
+    /* Conditional task: slope estimate for the cruise control law (slope.h) */
+    xImuQueue = xMemQueueCreate(IMU_QUEUE_LENGTH, sizeof(ImuSample_t));
+    xMemTaskCreate(vSlopeTask, "Slope Task", STACK_SLOPE_TASK, (void*) VEHICLE_PERIOD, SLOPE_PRIO, &xSlope_handle);
+#endif
+
+    /* Formats the Control/Display log records off the hot path */
+    xMemTaskCreate(vLogDrainTask, "Log Drain Task",  STACK_LOG_DRAIN_TASK, (void*) LOGDRAIN_PERIOD,  LOGDRAIN_PRIO,  &xLogDrain_handle);
+
+#if SMP_CORES > 1
+    /* The control loop gets a core of its own; load, display and log
+     * formatting cannot delay it. Watchdog, overload detection and the
+     * statistics tasks may run on either core. */
+    vTaskCoreAffinitySet(xButton_handle,    CORE_CONTROL);
+    vTaskCoreAffinitySet(xVehicle_handle,   CORE_CONTROL);
+    vTaskCoreAffinitySet(xControl_handle,   CORE_CONTROL);
+#if GEARBOX
+    vTaskCoreAffinitySet(xGearbox_handle,   CORE_CONTROL);
+#endif
+#if SLOPE_ESTIMATE
+    vTaskCoreAffinitySet(xSlope_handle,     CORE_CONTROL);
+#endif
+    vTaskCoreAffinitySet(xDisplay_handle,   CORE_SERVICE);
+    vTaskCoreAffinitySet(xLogDrain_handle,  CORE_SERVICE);
+    vTaskCoreAffinitySet(xExtraLoad_handle, CORE_SERVICE);
+#endif
+
+#if RUNTIME_STATS
+    /* CPU share of every task and idle fraction, see runstats.h */
+    xMemTaskCreate(vRunStatsTask, "RunStats Task", STACK_RUNSTATS_TASK, (void*) RUNSTATS_PERIOD, 1, NULL);
+#endif
+
+#if LOAD_SWEEP
+    /* Steps ExtraLoad and reports the misses per step, see load.h */
+    xMemTaskCreate(vLoadSweepTask, "Load Sweep Task", STACK_LOAD_SWEEP_TASK, NULL, configMAX_PRIORITIES - 1, &xLoadSweep_handle);
+#if SMP_CORES > 1
+    /* Not on the control core, where it would delay Control */
+    vTaskCoreAffinitySet(xLoadSweep_handle, CORE_SERVICE);
+#endif
+#endif
+
+#if MEMORY_MAP
+    /* Stack high-water marks and right-sized stacks, see mem.h */
+    xMemTaskCreate(vMemMapTask, "MemMap Task", STACK_MEMMAP_TASK, NULL, 1, NULL);
+#endif
+
+#if configUSE_JOB_TRACE
+    /* Per-job release/start/preempt/completion trace of the periodic tasks */
+    vTraceRegisterTask(xButton_handle,    "Button");
+    vTraceRegisterTask(xVehicle_handle,   "Vehicle");
+    vTraceRegisterTask(xControl_handle,   "Control");
+    vTraceRegisterTask(xDisplay_handle,   "Display");
+    vTraceRegisterTask(xExtraLoad_handle, "ExtraLoad");
+#if GEARBOX
+    vTraceRegisterTask(xGearbox_handle,   "Gearbox");
+#endif
+    /* Not Slope: it waits on a queue, never in vTaskDelayUntil, so the
+     * trace would see no job complete and every wait as a preemption. */
+    xMemTaskCreate(vTraceDumpTask, "Trace Dump Task", STACK_TRACE_DUMP_TASK, (void*) TRACE_DUMP_PERIOD, 1, NULL);
+#endif
+
+    /* Create the shared state (replaces the message queues) */
+    vBusInit();
+
+#if BUS_BENCH
+    /* Runs first and once: cost of a publish and a snapshot read */
+    xMemTaskCreate(vBusBenchTask, "Bus Bench Task", STACK_BUS_BENCH_TASK, NULL, configMAX_PRIORITIES - 1, NULL);
+#endif
+
+    xWatchdogTimer = xMemTimerCreate("Watchdog Timer", pdMS_TO_TICKS(1000), pdFALSE, 0, vTimerCallback);
     xTimerStart(xWatchdogTimer, portMAX_DELAY);    
 
     vTaskStartScheduler();  /* Start the scheduler. */
@@ -0,0 +1,230 @@
+/**
+ * @file mem.c
+ * @brief Task, queue and timer creation and the memory map, see mem.h.
+ */
+#include <stdio.h>
+#include <ctype.h>
+#include "bsp.h"
+#include "mem.h"
+
+typedef struct {
+    TaskHandle_t           handle;  /* NULL once the task deleted itself */
+    const char            *name;
+    configSTACK_DEPTH_TYPE depth;
+    UBaseType_t            unused;  /* final high-water mark of a deleted task */
+} MemTask_t;
+
+static MemTask_t tasks[MEM_MAX_TASKS];
+static UBaseType_t n_tasks;
+
+#if STATIC_ALLOC
+static StaticTask_t  tcb_pool[MEM_MAX_TASKS];
+static size_t        stack_used;
+
+static StaticQueue_t queue_pool[MEM_MAX_QUEUES];
+static uint8_t       queue_arena[MEM_QUEUE_ARENA_BYTES];
+static size_t        queue_used;
+static UBaseType_t   n_queues;
+
+static StaticTimer_t timer_pool[MEM_MAX_TIMERS];
+static UBaseType_t   n_timers;
+
+/* Kernel-owned tasks */
+static StaticTask_t  idle_tcb;
+static StackType_t   idle_stack[configMINIMAL_STACK_SIZE];
+#if configNUMBER_OF_CORES > 1
+static StaticTask_t  passive_idle_tcb[configNUMBER_OF_CORES - 1];
+static StackType_t   passive_idle_stack[configNUMBER_OF_CORES - 1][configMINIMAL_STACK_SIZE];
+#endif
+static StaticTask_t  timer_tcb;
+static StackType_t   timer_stack[configTIMER_TASK_STACK_DEPTH];
+#endif
+
+/* Same reaction as an unschedulable task set: stop before anything runs. */
+static void mem_fail(const char *what, const char *name) {
+    printf("--- OUT OF MEMORY: %s %s ---\n", what, name);
+    BSP_SetLED(LED_GREEN, 1);
+    BSP_SetLED(LED_YELLOW, 1);
+    BSP_SetLED(LED_RED, 1);
+    while (true) {
+        sleep_ms(1000);
+    }
+}
+
+TaskHandle_t xMemTaskCreate(TaskFunction_t pxTask, const char *pcName,
+                            configSTACK_DEPTH_TYPE usStackDepth, void *pvArg,
+                            UBaseType_t uxPriority, TaskHandle_t *pxHandle) {
+    TaskHandle_t handle = NULL;
+
+    if (n_tasks == MEM_MAX_TASKS)
+        mem_fail("task", pcName);
+#if STATIC_ALLOC
+    if (stack_used + usStackDepth > uxMemStackArenaWords)
+        mem_fail("stack", pcName);
+    handle = xTaskCreateStatic(pxTask, pcName, usStackDepth, pvArg, uxPriority,
+                               &xMemStackArena[stack_used], &tcb_pool[n_tasks]);
+    stack_used += usStackDepth;
+#else
+    if (xTaskCreate(pxTask, pcName, usStackDepth, pvArg, uxPriority, &handle) != pdPASS)
+        handle = NULL;
+#endif
+    if (handle == NULL)
+        mem_fail("task", pcName);
+
+    tasks[n_tasks].handle = handle;
+    tasks[n_tasks].name = pcName;
+    tasks[n_tasks].depth = usStackDepth;
+    n_tasks++;
+    if (pxHandle != NULL)
+        *pxHandle = handle;
+    return handle;
+}
+
+void vMemTaskDelete(void) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    UBaseType_t i;
+
+    taskENTER_CRITICAL();
+    for (i = 0; i < n_tasks; i++) {
+        if (tasks[i].handle == self) {
+            tasks[i].unused = uxTaskGetStackHighWaterMark(NULL);
+            tasks[i].handle = NULL;
+        }
+    }
+    taskEXIT_CRITICAL();
+    vTaskDelete(NULL);
+}
+
+QueueHandle_t xMemQueueCreate(UBaseType_t uxLength, UBaseType_t uxItemSize) {
+    QueueHandle_t queue;
+#if STATIC_ALLOC
+    size_t bytes = (size_t) uxLength * uxItemSize;
+
+    if (n_queues == MEM_MAX_QUEUES || queue_used + bytes > MEM_QUEUE_ARENA_BYTES)
+        mem_fail("queue", "");
+    queue = xQueueCreateStatic(uxLength, uxItemSize, &queue_arena[queue_used], &queue_pool[n_queues]);
+    queue_used += bytes;
+    n_queues++;
+#else
+    queue = xQueueCreate(uxLength, uxItemSize);
+#endif
+    if (queue == NULL)
+        mem_fail("queue", "");
+    return queue;
+}
+
+TimerHandle_t xMemTimerCreate(const char *pcName, TickType_t xPeriod, UBaseType_t uxAutoReload,
+                              void *pvTimerID, TimerCallbackFunction_t pxCallback) {
+    TimerHandle_t timer;
+#if STATIC_ALLOC
+    if (n_timers == MEM_MAX_TIMERS)
+        mem_fail("timer", pcName);
+    timer = xTimerCreateStatic(pcName, xPeriod, uxAutoReload, pvTimerID, pxCallback,
+                               &timer_pool[n_timers++]);
+#else
+    timer = xTimerCreate(pcName, xPeriod, uxAutoReload, pvTimerID, pxCallback);
+#endif
+    if (timer == NULL)
+        mem_fail("timer", pcName);
+    return timer;
+}
+
+#if STATIC_ALLOC
+/* Memory of the idle and timer service tasks (configSUPPORT_STATIC_ALLOCATION). */
+#if tskKERNEL_VERSION_MAJOR >= 11
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxTCB, StackType_t **ppxStack,
+                                   configSTACK_DEPTH_TYPE *puxStackSize) {
+#else
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppxTCB, StackType_t **ppxStack,
+                                   uint32_t *puxStackSize) {
+#endif
+    *ppxTCB = &idle_tcb;
+    *ppxStack = idle_stack;
+    *puxStackSize = configMINIMAL_STACK_SIZE;
+}
+
+#if configNUMBER_OF_CORES > 1
+/* Idle tasks of the other cores (SMP_CORES 2) */
+void vApplicationGetPassiveIdleTaskMemory(StaticTask_t **ppxTCB, StackType_t **ppxStack,
+                                          configSTACK_DEPTH_TYPE *puxStackSize,
+                                          BaseType_t xPassiveIdleTaskIndex) {
+    *ppxTCB = &passive_idle_tcb[xPassiveIdleTaskIndex];
+    *ppxStack = passive_idle_stack[xPassiveIdleTaskIndex];
+    *puxStackSize = configMINIMAL_STACK_SIZE;
+}
+#endif
+
+#if tskKERNEL_VERSION_MAJOR >= 11
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTCB, StackType_t **ppxStack,
+                                    configSTACK_DEPTH_TYPE *puxStackSize) {
+#else
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTCB, StackType_t **ppxStack,
+                                    uint32_t *puxStackSize) {
+#endif
+    *ppxTCB = &timer_tcb;
+    *ppxStack = timer_stack;
+    *puxStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+#endif /* STATIC_ALLOC */
+
+static uint32_t fit_words(uint32_t used) {
+    uint32_t fit = used + used / 4 + MEM_STACK_SLACK;
+
+    return fit < configMINIMAL_STACK_SIZE ? configMINIMAL_STACK_SIZE : fit;
+}
+
+/* The handle is only read under the critical section of vMemTaskDelete(),
+ * so the TCB of a deleted task, freed by the idle task, is never used. */
+static UBaseType_t unused_words(UBaseType_t i) {
+    UBaseType_t unused;
+
+    taskENTER_CRITICAL();
+    if (tasks[i].handle != NULL)
+        tasks[i].unused = uxTaskGetStackHighWaterMark(tasks[i].handle);
+    unused = tasks[i].unused;
+    taskEXIT_CRITICAL();
+    return unused;
+}
+
+void vMemMapReport(void) {
+    UBaseType_t i;
+
+    printf("--- MEMORY MAP (stack words) ---\n");
+    printf("%-24s %6s %6s %6s %6s\n", "task", "size", "used", "free", "fit");
+    for (i = 0; i < n_tasks; i++) {
+        UBaseType_t unused = unused_words(i);
+        uint32_t used = tasks[i].depth - unused;
+
+        printf("%-24s %6lu %6lu %6lu %6lu%s\n", tasks[i].name, (unsigned long) tasks[i].depth,
+               (unsigned long) used, (unsigned long) unused, (unsigned long) fit_words(used),
+               tasks[i].handle == NULL ? " (deleted)" : "");
+    }
+#if STATIC_ALLOC
+    printf("stack arena %lu/%lu words, queue arena %lu/%lu bytes, %lu queues, %lu timers\n",
+           (unsigned long) stack_used, (unsigned long) uxMemStackArenaWords,
+           (unsigned long) queue_used, (unsigned long) MEM_QUEUE_ARENA_BYTES,
+           (unsigned long) n_queues, (unsigned long) n_timers);
+#endif
+
+    // Right-sized stacks, for stack_sizes_measured.h
+    for (i = 0; i < n_tasks; i++) {
+        uint32_t used = tasks[i].depth - tasks[i].unused;
+        const char *c;
+
+        printf("#define STACK_");
+        for (c = tasks[i].name; *c != '\0'; c++)
+            putchar(isalnum((unsigned char) *c) ? toupper((unsigned char) *c) : '_');
+        printf(" %lu\n", (unsigned long) fit_words(used));
+    }
+}
+
+void vMemMapTask(void *args) {
+    TickType_t xLastWakeTime = 0;
+
+    (void) args;
+    vTaskDelayUntil(&xLastWakeTime, MEM_MAP_DELAY);
+    while(true) {
+        vMemMapReport();
+        vTaskDelayUntil(&xLastWakeTime, MEM_MAP_PERIOD);
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * @file mem.h
+ * @brief Creation of the application's tasks, queues and timers, and
+ *        the memory map.
+ *
+ *        With STATIC_ALLOC = 1 nothing comes from the FreeRTOS heap:
+ *        task stacks and queue storage are carved from fixed arenas,
+ *        TCBs and queue/timer control blocks from fixed pools, all
+ *        sized at compile time (configSUPPORT_STATIC_ALLOCATION 1,
+ *        configSUPPORT_DYNAMIC_ALLOCATION 0). Otherwise the heap is
+ *        used as before. Either way a failed creation stops the system
+ *        at startup with a message instead of running on a NULL handle.
+ *
+ *        With MEMORY_MAP = 1 vMemMapTask() prints every task's stack
+ *        size and high-water mark and, as "#define STACK_<NAME> <words>"
+ *        lines, a stack size right-sized from the measured use. Saved
+ *        as stack_sizes_measured.h and built with STACK_SIZES_MEASURED = 1,
+ *        they replace the defaults of stack_sizes.h.
+ */
+#ifndef MEM_H
+#define MEM_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+
+#ifndef STATIC_ALLOC
+#define STATIC_ALLOC 0
+#endif
+
+#ifndef MEMORY_MAP
+#define MEMORY_MAP 0
+#endif
+
+#define MEM_MAX_TASKS       20
+#define MEM_MAX_QUEUES      16
+#define MEM_MAX_TIMERS      4
+
+/* STATIC_ALLOC: the application defines the stack arena once, with the
+ * words of all the tasks it creates. */
+#define MEM_STACK_ARENA(words)  StackType_t xMemStackArena[(words)];  \
+                                const size_t uxMemStackArenaWords = (words)
+extern StackType_t xMemStackArena[];
+extern const size_t uxMemStackArenaWords;
+
+/* Bytes of all queue storage together (STATIC_ALLOC) */
+#ifndef MEM_QUEUE_ARENA_BYTES
+#define MEM_QUEUE_ARENA_BYTES   256
+#endif
+
+#define MEM_MAP_DELAY       5000    /* ms before the first map */
+#define MEM_MAP_PERIOD      30000   /* ms between two maps */
+
+/* Right-sized stack: measured use plus a quarter and MEM_STACK_SLACK words */
+#define MEM_STACK_SLACK     32
+
+TaskHandle_t xMemTaskCreate(TaskFunction_t pxTask, const char *pcName,
+                            configSTACK_DEPTH_TYPE usStackDepth, void *pvArg,
+                            UBaseType_t uxPriority, TaskHandle_t *pxHandle);
+
+/* Ends the calling task: records its final stack high-water mark for the
+ * map, then vTaskDelete(NULL). Use it instead of vTaskDelete(NULL) in a
+ * task created by xMemTaskCreate(). */
+void vMemTaskDelete(void);
+
+QueueHandle_t xMemQueueCreate(UBaseType_t uxLength, UBaseType_t uxItemSize);
+
+TimerHandle_t xMemTimerCreate(const char *pcName, TickType_t xPeriod, UBaseType_t uxAutoReload,
+                              void *pvTimerID, TimerCallbackFunction_t pxCallback);
+
+/* Prints the stack high-water marks and the right-sized stacks. */
+void vMemMapReport(void);
+
+/* Lowest priority task printing the map after MEM_MAP_DELAY, then every MEM_MAP_PERIOD. */
+void vMemMapTask(void *args);
+
+#endif /* MEM_H */
@@ -0,0 +1,175 @@
+/**
+ * @file plant_sim.c
+ * @brief Closed-loop plant simulation, see plant_sim.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "plant_sim.h"
+#include "vehicle.h"
+#include "gearbox.h"
+#include "slope.h"
+
+void plant_scenario_default(PlantScenario_t *sc) {
+    static const PidGains_t gains = PID_GAINS_DEFAULT;
+
+    memset(sc, 0, sizeof(*sc));
+    sc->duration_ms = 100000;
+    sc->vehicle_period = 100;
+    sc->control_period = 200;
+    sc->law = CRUISE_CONTROLLER;
+    sc->gearbox = GEARBOX;
+    sc->terrain_ff = CONTROLLER_TERRAIN_FF;
+    sc->gains = gains;
+}
+
+void plant_run(const PlantScenario_t *sc, PlantResult_t *result,
+               PlantSampleFn on_sample, void *ctx) {
+    CruiseControl_t cc;
+    Gearbox_t gb;
+    SlopeFilter_t filter;
+    uint16_t noise = 1;
+    uint8_t gear = GEAR_NONE;
+    bool pressed[PLANT_INPUTS] = { false };
+    size_t next_event = 0;
+    uint16_t position = 0;
+    uint16_t velocity = 0;
+    uint16_t throttle = 0;
+    double sum_sq = 0;
+    uint32_t step = sc->vehicle_period;
+    uint32_t rest = sc->control_period;
+    uint32_t t;
+
+    // Only the common releases matter: step by the gcd of the periods.
+    while (rest != 0) {
+        uint32_t r = step % rest;
+
+        step = rest;
+        rest = r;
+    }
+
+    cruise_init(&cc);
+    cc.law = sc->law;
+    cc.terrain_ff = sc->terrain_ff;
+    cc.gains = sc->gains;
+    gearbox_init(&gb);
+    slope_init(&filter);
+    memset(result, 0, sizeof(*result));
+
+    for (t = 0; t < sc->duration_ms; t += step) {
+        bool vehicle = t % sc->vehicle_period == 0;
+        bool control = t % sc->control_period == 0;
+
+        if (!vehicle && !control)
+            continue;
+        while (next_event < sc->n_events && sc->events[next_event].t_ms <= t) {
+            pressed[sc->events[next_event].input] = sc->events[next_event].pressed;
+            next_event++;
+        }
+
+        if (vehicle) {
+            uint16_t last_velocity = velocity;
+            int8_t acceleration;
+            ImuSample_t sample;
+
+            if (sc->gearbox)
+                gear = gearbox_select(&gb, GEAR_AUTO, velocity);
+            acceleration = gearbox_acceleration(throttle, gear, position, velocity);
+
+            position = adjust_position(position, velocity, acceleration, sc->vehicle_period);
+            velocity = adjust_velocity(velocity, acceleration, pressed[PLANT_BRAKE],
+                                       sc->vehicle_period);
+            sample = imu_sample(acceleration, gearbox_thrust(throttle, gear, last_velocity),
+                                pressed[PLANT_BRAKE], last_velocity, velocity, &noise);
+            cc.slope = slope_update(&filter, &sample);
+        }
+
+        if (control) {
+            uint16_t new_throttle;
+
+            cc.drive_gain = gearbox_gain(gear, velocity);
+            new_throttle = cruise_update(&cc, pressed[PLANT_CRUISE],
+                                                  pressed[PLANT_GAS], pressed[PLANT_BRAKE],
+                                                  velocity, position);
+            if (new_throttle != throttle)
+                result->throttle_changes++;
+            throttle = new_throttle;
+        }
+
+        if (vehicle) {
+            if (cc.state == CRUISE_ACTIVE) {
+                int32_t error = (int32_t) velocity - cc.cruise_velocity;
+
+                sum_sq += (double) error * error;
+                result->active_samples++;
+                if (abs(error) > abs(result->max_error))
+                    result->max_error = error;
+            }
+            if (on_sample != NULL) {
+                PlantSample_t sample = { t, position, velocity, cc.cruise_velocity,
+                                         throttle, cc.state, gear };
+                on_sample(ctx, &sample);
+            }
+        }
+    }
+
+    result->rms_error = result->active_samples ? sqrt(sum_sq / result->active_samples) : 0;
+    result->final_velocity = velocity;
+    result->final_position = position;
+    result->shifts = gb.shifts;
+}
+
+int plant_load_events(const char *path, PlantEvent_t **events) {
+    static const char *const names[PLANT_INPUTS] = { "SW_6", "SW_5", "SW_7" };
+    FILE *f = fopen(path, "r");
+    PlantEvent_t *ev = NULL;
+    size_t n = 0, size = 0;
+    char line[128];
+    char name[16];
+    unsigned long t;
+    int level;
+    int i;
+
+    if (f == NULL)
+        return -1;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (line[0] == '#' || sscanf(line, "%lu %15s %d", &t, name, &level) != 3)
+            continue;
+        for (i = 0; i < PLANT_INPUTS && strcmp(name, names[i]) != 0; i++)
+            ;
+        if (i == PLANT_INPUTS)
+            continue;                       /* load switches */
+        if (n == size) {
+            PlantEvent_t *grown;
+
+            size = size ? 2 * size : 16;
+            grown = realloc(ev, size * sizeof(*ev));
+            if (grown == NULL) {
+                free(ev);
+                fclose(f);
+                return -1;
+            }
+            ev = grown;
+        }
+        ev[n].t_ms = (uint32_t) t;
+        ev[n].input = (uint8_t) i;
+        ev[n].pressed = level == 0;         /* active low */
+        n++;
+    }
+    fclose(f);
+
+    // Stable for equal times: insertion order decides, as in the script.
+    for (size_t k = 1; k < n; k++) {
+        PlantEvent_t e = ev[k];
+        size_t j = k;
+
+        while (j > 0 && ev[j - 1].t_ms > e.t_ms) {
+            ev[j] = ev[j - 1];
+            j--;
+        }
+        ev[j] = e;
+    }
+    *events = ev;
+    return (int) n;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file plant_sim.h
+ * @brief Deterministic closed-loop simulation of the cruise control
+ *        without the RTOS: the plant of vehicle.c stepped every
+ *        vehicle_period ms and cruise_update() of controller.c every
+ *        control_period ms, driven by a timeline of pedal and cruise
+ *        button events.
+ *
+ *        At a common release Vehicle runs first (it has the higher
+ *        priority), so Control sees the velocity of the same instant,
+ *        as in main.c. Inputs are sampled at each release; the Button
+ *        task's 50 ms polling is not modelled. With gearbox set, the
+ *        automatic shift decision of the Gearbox task runs just before
+ *        every Vehicle step (gearbox.h). The accelerometer sample of a
+ *        step goes through the slope filter (slope.h) right after it.
+ *
+ *        The library keeps no global state and is safe to call from
+ *        several threads at once.
+ */
+#ifndef PLANT_SIM_H
+#define PLANT_SIM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller.h"
+
+enum { PLANT_GAS, PLANT_BRAKE, PLANT_CRUISE, PLANT_INPUTS };
+
+typedef struct {
+    uint32_t t_ms;
+    uint8_t  input;         /* PLANT_GAS, PLANT_BRAKE or PLANT_CRUISE */
+    bool     pressed;
+} PlantEvent_t;
+
+typedef struct {
+    const PlantEvent_t *events;     /* sorted by t_ms */
+    size_t   n_events;
+    uint32_t duration_ms;
+    uint16_t vehicle_period;        /* ms, 100 in main.c */
+    uint16_t control_period;        /* ms, 200 in main.c */
+    uint8_t  law;                   /* as CRUISE_CONTROLLER */
+    bool     gearbox;               /* as GEARBOX */
+    uint8_t  terrain_ff;            /* as CONTROLLER_TERRAIN_FF */
+    PidGains_t gains;
+} PlantScenario_t;
+
+/* State after each Vehicle step */
+typedef struct {
+    uint32_t t_ms;
+    uint16_t position;
+    uint16_t velocity;
+    uint16_t cruise_velocity;
+    uint16_t throttle;
+    uint8_t  state;         /* STATE of the cruise control */
+    uint8_t  gear;          /* GEAR_NONE without gearbox */
+} PlantSample_t;
+
+/* Velocity error statistics over the samples in CRUISE_ACTIVE */
+typedef struct {
+    uint32_t active_samples;
+    int32_t  max_error;     /* signed, largest magnitude */
+    double   rms_error;
+    uint32_t throttle_changes;
+    uint16_t final_velocity;
+    uint16_t final_position;
+    uint32_t shifts;
+} PlantResult_t;
+
+typedef void (*PlantSampleFn)(void *ctx, const PlantSample_t *sample);
+
+/* Fills in the periods, law, gains and gearbox of main.c, controller.h
+ * and gearbox.h. */
+void plant_scenario_default(PlantScenario_t *sc);
+
+/* Runs sc; calls on_sample (if not NULL) after every Vehicle step. */
+void plant_run(const PlantScenario_t *sc, PlantResult_t *result,
+               PlantSampleFn on_sample, void *ctx);
+
+/*
+ * Reads a timeline in the SIM_SCRIPT format of sim/bsp.c,
+ * "<ms> <input> <level>" with level 0 = pressed. Only the pedals and
+ * the cruise button (SW_5, SW_6, SW_7) are used. Returns the number of
+ * events in the malloc'ed *events, or -1 if the file cannot be read.
+ */
+int plant_load_events(const char *path, PlantEvent_t **events);
+
+#endif /* PLANT_SIM_H */
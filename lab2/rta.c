@@ -0,0 +1,102 @@
+/**
+ * @file rta.c
+ * @brief Fixed-priority schedulability analysis, see rta.h.
+ */
+#include <stdio.h>
+#include "rta.h"
+
+/* floor(n (2^(1/n) - 1) * 10^6) for n = 1..16, the bound tends to ln 2. */
+static const uint32_t ll_bound[16] = {
+    1000000, 828427, 779763, 756828, 743491, 734772, 728626, 724061,
+    720537, 717734, 715451, 713557, 711958, 710592, 709411, 708380
+};
+
+uint32_t ulRtaUtilisation(const RtaTask_t *set, int n) {
+    uint64_t u = 0;
+
+    for (int i = 0; i < n; i++) {
+        // Round every term up, the test must stay on the safe side.
+        u += ((uint64_t) set[i].wcet_us * 1000000 + set[i].period_us - 1) / set[i].period_us;
+    }
+    return u > UINT32_MAX ? UINT32_MAX : (uint32_t) u;
+}
+
+uint32_t ulRtaLiuLaylandBound(int n) {
+    if (n <= 0)
+        return 1000000;
+    if (n > 16)
+        return 693147;  /* ln 2 */
+    return ll_bound[n - 1];
+}
+
+uint32_t ulRtaResponseTime(const RtaTask_t *set, int n, int i) {
+    const RtaTask_t *t = &set[i];
+    uint64_t r = t->wcet_us + t->blocking_us;
+    uint64_t limit = t->deadline_us;
+    uint64_t next;
+
+    // Past the next release the job would delay the next one, which a
+    // single-job analysis does not see: stay on the safe side.
+    if (limit > t->period_us)
+        limit = t->period_us;
+
+    // R(k+1) = C + B + sum over hp(i) of ceil(R(k) / Tj) * Cj,
+    // starting from R(0) = C + B until it converges or passes D.
+    for (;;) {
+        next = t->wcet_us + t->blocking_us;
+        for (int j = 0; j < n; j++) {
+            if (j == i || set[j].priority < t->priority)
+                continue;
+            next += (r + set[j].period_us - 1) / set[j].period_us * set[j].wcet_us;
+        }
+        if (next > limit)
+            return RTA_UNSCHEDULABLE;
+        if (next == r)
+            return (uint32_t) r;
+        r = next;
+    }
+}
+
+static void print_us(uint32_t us) {
+    printf("%lu.%03lu", (unsigned long) (us / 1000), (unsigned long) (us % 1000));
+}
+
+bool xRtaCheck(const RtaTask_t *set, int n, bool verbose) {
+    uint32_t u = ulRtaUtilisation(set, n);
+    uint32_t bound = ulRtaLiuLaylandBound(n);
+    bool ok = true;
+
+    if (verbose)
+        printf("--- RESPONSE TIME ANALYSIS (ms) ---\n");
+    for (int i = 0; i < n; i++) {
+        uint32_t r = ulRtaResponseTime(set, n, i);
+
+        if (r == RTA_UNSCHEDULABLE)
+            ok = false;
+        if (!verbose)
+            continue;
+        printf("%-12s P:%2d T: ", set[i].name, set[i].priority);
+        print_us(set[i].period_us);
+        printf(", C: ");
+        print_us(set[i].wcet_us);
+        printf(", B: ");
+        print_us(set[i].blocking_us);
+        printf(", D: ");
+        print_us(set[i].deadline_us);
+        if (r == RTA_UNSCHEDULABLE) {
+            printf(" ==> misses its deadline!\n");
+        } else {
+            printf(", WCRT: ");
+            print_us(r);
+            printf("\n");
+        }
+    }
+    if (verbose) {
+        printf("U = %lu.%02lu%%, Liu-Layland bound = %lu.%02lu%% (%s), RTA: %s\n",
+               (unsigned long) (u / 10000), (unsigned long) (u / 100 % 100),
+               (unsigned long) (bound / 10000), (unsigned long) (bound / 100 % 100),
+               u <= bound ? "passed" : "not passed",
+               ok ? "schedulable" : "NOT SCHEDULABLE");
+    }
+    return ok;
+}
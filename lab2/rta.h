@@ -0,0 +1,46 @@
+/**
+ * @file rta.h
+ * @brief Fixed-priority schedulability analysis of a periodic task set.
+ *
+ *        Exact response-time analysis (iterative WCRT with blocking
+ *        terms) and the Liu-Layland utilisation bound. Pure C without
+ *        FreeRTOS, so the same code checks the task table in main()
+ *        before the scheduler starts and runs on the host in
+ *        tools/rta_check.c.
+ */
+#ifndef RTA_H
+#define RTA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define RTA_MAX_TASKS       16
+#define RTA_UNSCHEDULABLE   UINT32_MAX
+
+typedef struct {
+    const char *name;
+    uint32_t period_us;
+    uint32_t deadline_us;   /* relative deadline, may exceed a sporadic period */
+    uint32_t wcet_us;       /* declared or measured WCET */
+    uint32_t blocking_us;   /* longest blocking by lower priority tasks */
+    uint8_t  priority;      /* higher number = higher priority, as in FreeRTOS */
+} RtaTask_t;
+
+/* Total utilisation in parts per million. */
+uint32_t ulRtaUtilisation(const RtaTask_t *set, int n);
+
+/* Liu-Layland bound n(2^(1/n) - 1) in parts per million. */
+uint32_t ulRtaLiuLaylandBound(int n);
+
+/* WCRT of task i, or RTA_UNSCHEDULABLE if it exceeds the deadline.
+ * The analysis covers one job at a time: with a deadline above the
+ * period (minimum inter-arrival time) the WCRT must also stay within
+ * the period, else the task is reported unschedulable. Tasks of equal priority are counted as interference (FIFO order
+ * within a priority is not known in advance). */
+uint32_t ulRtaResponseTime(const RtaTask_t *set, int n, int i);
+
+/* Runs both tests, prints a report if verbose and returns true if every
+ * task meets its deadline according to the exact analysis. */
+bool xRtaCheck(const RtaTask_t *set, int n, bool verbose);
+
+#endif /* RTA_H */
@@ -0,0 +1,83 @@
+/**
+ * @file runstats.c
+ * @brief CPU utilisation per task, see runstats.h.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "runstats.h"
+
+#if RUNTIME_STATS
+
+typedef struct {
+    UBaseType_t number;     /* xTaskNumber, unique per task */
+    uint32_t    counter;
+} RunStatsLast_t;
+
+static TaskStatus_t status[RUNSTATS_MAX_TASKS];
+static RunStatsLast_t last[RUNSTATS_MAX_TASKS];
+static uint32_t delta[RUNSTATS_MAX_TASKS];   /* off the task stack */
+static UBaseType_t n_last;
+
+static uint32_t last_counter(UBaseType_t number) {
+    UBaseType_t i;
+
+    for (i = 0; i < n_last; i++) {
+        if (last[i].number == number)
+            return last[i].counter;
+    }
+    return 0;               /* created since the previous report */
+}
+
+void vRunStatsReport(void) {
+    uint32_t total = 0;
+    uint32_t idle = 0;
+    uint32_t total_counter;
+    UBaseType_t n, i;
+
+    n = uxTaskGetSystemState(status, RUNSTATS_MAX_TASKS, &total_counter);
+    if (n == 0) {
+        printf("--- RUNSTATS: more than %d tasks ---\n", RUNSTATS_MAX_TASKS);
+        return;
+    }
+
+    // Unsigned differences stay right across a counter wrap.
+    for (i = 0; i < n; i++) {
+        delta[i] = status[i].ulRunTimeCounter - last_counter(status[i].xTaskNumber);
+        total += delta[i];
+        if (strncmp(status[i].pcTaskName, "IDLE", 4) == 0)
+            idle += delta[i];
+    }
+    if (total == 0)
+        return;
+
+    printf("--- RUNSTATS over %lu us ---\n", (unsigned long) total);
+    for (i = 0; i < n; i++) {
+        // Hundredths of a percent.
+        uint32_t share = (uint32_t) ((uint64_t) delta[i] * 10000 / total);
+
+        printf("%-24s %3lu.%02lu %%\n", status[i].pcTaskName,
+               (unsigned long) (share / 100), (unsigned long) (share % 100));
+        last[i].number = status[i].xTaskNumber;
+        last[i].counter = status[i].ulRunTimeCounter;
+    }
+    n_last = n;
+    printf("Busy %lu.%02lu %%, idle %lu.%02lu %%\n",
+           (unsigned long) ((total - idle) * 10000ull / total / 100),
+           (unsigned long) ((total - idle) * 10000ull / total % 100),
+           (unsigned long) (idle * 10000ull / total / 100),
+           (unsigned long) (idle * 10000ull / total % 100));
+}
+
+void vRunStatsTask(void *args) {
+    TickType_t xLastWakeTime = 0;
+    const TickType_t xPeriod = (uint32_t) args;
+
+    while(true) {
+        vTaskDelayUntil(&xLastWakeTime, xPeriod);
+        vRunStatsReport();
+    }
+}
+
+#endif /* RUNTIME_STATS */
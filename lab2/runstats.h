@@ -0,0 +1,39 @@
+/**
+ * @file runstats.h
+ * @brief CPU utilisation per task from the FreeRTOS run-time stats.
+ *
+ *        With RUNTIME_STATS = 1 the kernel charges every context to the
+ *        task that ran, using the 1 MHz timer of ulTraceClockUs() as the
+ *        run-time counter. vRunStatsTask() prints, every
+ *        RUNSTATS_PERIOD, the share of each task over that interval and
+ *        the idle fraction. The tick keeps running in this mode.
+ *
+ *        The FreeRTOSConfig.h of the build needs
+ *          #define configGENERATE_RUN_TIME_STATS           RUNTIME_STATS
+ *          #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+ *          #define portGET_RUN_TIME_COUNTER_VALUE()        ulTraceClockUs()
+ *        and configUSE_TRACE_FACILITY 1 (sim/FreeRTOSConfig.h has them).
+ */
+#ifndef RUNSTATS_H
+#define RUNSTATS_H
+
+#include <stdint.h>
+#include "mem.h"
+
+#ifndef RUNTIME_STATS
+#define RUNTIME_STATS 0
+#endif
+
+#define RUNSTATS_PERIOD     10000   /* ms between two reports */
+/* Every application task (at most MEM_MAX_TASKS) plus the kernel's:
+ * one Idle task per core, Tmr Svc and, in the host build, Sim Task. */
+#define RUNSTATS_KERNEL_TASKS   4
+#define RUNSTATS_MAX_TASKS  (MEM_MAX_TASKS + RUNSTATS_KERNEL_TASKS)
+
+/* Prints the utilisation of every task since the previous call. */
+void vRunStatsReport(void);
+
+/* Lowest priority task calling vRunStatsReport() every RUNSTATS_PERIOD. */
+void vRunStatsTask(void *args);
+
+#endif /* RUNSTATS_H */
@@ -0,0 +1,98 @@
+/**
+ * @file FreeRTOSConfig.h
+ * @brief FreeRTOS configuration for the host (POSIX/Linux port) build
+ *        of the lab2 applications.
+ *
+ *        One tick is still one (simulated) millisecond for the
+ *        application: task periods are given in ticks and
+ *        pdMS_TO_TICKS() is the identity. Only the port's wall-clock
+ *        tick interval is shortened, so the whole system runs
+ *        SIM_TICKS_PER_WALL_MS times faster than real time.
+ */
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+/* Simulated ticks per wall-clock millisecond (1 = real time). */
+#ifndef SIM_TICKS_PER_WALL_MS
+#define SIM_TICKS_PER_WALL_MS               1000
+#endif
+
+/* Utilisation per task from the run-time stats, see runstats.h. */
+#ifndef RUNTIME_STATS
+#define RUNTIME_STATS                       0
+#endif
+
+/* Watchdog petting from the idle hook instead of a polling task (main.c).
+ * The POSIX port has no tickless idle, so unlike on the Lab-Kit the tick
+ * keeps running here. */
+#ifndef LOW_POWER
+#define LOW_POWER                           0
+#endif
+
+#if defined(SMP_CORES) && SMP_CORES > 1
+#error "The POSIX port runs on one core, SMP_CORES 2 is for the Lab-Kit"
+#endif
+
+#define configUSE_PREEMPTION                1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 0
+#define configUSE_IDLE_HOOK                 LOW_POWER
+#define configUSE_TICKLESS_IDLE             0
+#define configUSE_TICK_HOOK                 0
+/* The POSIX port derives its timer interval from this value, the
+ * application never sees it because pdMS_TO_TICKS is overridden below. */
+#define configTICK_RATE_HZ                  ( 1000UL * SIM_TICKS_PER_WALL_MS )
+#define configMAX_PRIORITIES                10
+#define configMINIMAL_STACK_SIZE            ( ( unsigned short ) 4096 )
+#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 256 * 1024 ) )
+#define configMAX_TASK_NAME_LEN             24
+#define configUSE_TRACE_FACILITY            1
+#define configUSE_16_BIT_TICKS              0
+#define configIDLE_SHOULD_YIELD             1
+#define configUSE_MUTEXES                   1
+#define configUSE_RECURSIVE_MUTEXES         1
+#define configUSE_COUNTING_SEMAPHORES       1
+#define configQUEUE_REGISTRY_SIZE           0
+#define configUSE_APPLICATION_TASK_TAG      1
+#define configCHECK_FOR_STACK_OVERFLOW      0
+#define configUSE_MALLOC_FAILED_HOOK        0
+/* No heap at all with STATIC_ALLOC, see mem.h. */
+#ifndef STATIC_ALLOC
+#define STATIC_ALLOC                        0
+#endif
+#define configSUPPORT_DYNAMIC_ALLOCATION    ( !STATIC_ALLOC )
+#define configSUPPORT_STATIC_ALLOCATION     STATIC_ALLOC
+#define configGENERATE_RUN_TIME_STATS       RUNTIME_STATS
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()    ulTraceClockUs()
+
+/* Per-job timing trace of the application tasks, see trace.h. */
+#ifndef configUSE_JOB_TRACE
+#define configUSE_JOB_TRACE                 0
+#endif
+
+#define configUSE_TIMERS                    1
+#define configTIMER_TASK_PRIORITY           ( configMAX_PRIORITIES - 1 )
+#define configTIMER_QUEUE_LENGTH            20
+#define configTIMER_TASK_STACK_DEPTH        ( configMINIMAL_STACK_SIZE * 2 )
+
+#define INCLUDE_vTaskPrioritySet            1
+#define INCLUDE_uxTaskPriorityGet           1
+#define INCLUDE_vTaskDelete                 1
+#define INCLUDE_vTaskSuspend                1
+#define INCLUDE_xTaskDelayUntil             1
+#define INCLUDE_vTaskDelayUntil             1
+#define INCLUDE_vTaskDelay                  1
+#define INCLUDE_xTaskGetSchedulerState      1
+#define INCLUDE_xTaskGetCurrentTaskHandle   1
+#define INCLUDE_uxTaskGetStackHighWaterMark 1
+#define INCLUDE_xTimerPendFunctionCall      1
+
+/* Application time base: one tick is one simulated millisecond. */
+#define pdMS_TO_TICKS( xTimeInMs )          ( ( TickType_t ) ( xTimeInMs ) )
+
+#define configASSERT( x )                   if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
+extern void vAssertCalled( const char * const pcFileName, unsigned long ulLine );
+
+#include "trace.h"
+
+#endif /* FREERTOS_CONFIG_H */
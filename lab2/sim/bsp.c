@@ -0,0 +1,253 @@
+/**
+ * @file bsp.c
+ * @brief Host stand-in for the ES Lab-Kit board support package.
+ *
+ *        BSP_Init() also creates a "Sim Task" that replays an input
+ *        script and stops the program once the run is finished.
+ *        The run is controlled by environment variables:
+ *
+ *        SIM_SCRIPT   file with lines "<ms> <input> <level>",
+ *                     e.g. "0 SW_6 0" presses the gas pedal at t = 0.
+ *        SIM_RUN_MS   simulated run time in ms (default 60000).
+ *        SIM_LAPS     stop after this many laps of the 24 position
+ *                     LEDs, i.e. 24000 position units (default 0 = off).
+ *        SIM_VERBOSE  echo LED and display updates to stdout.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "bsp.h"
+
+#define SIM_MAX_EVENTS      256
+#define SIM_TASK_PRIORITY   ( configMAX_PRIORITIES - 2 )
+
+typedef struct {
+    TickType_t  time;
+    Input_t     pin;
+    bool        level;
+} SimEvent_t;
+
+static const char *const input_names[INPUT_COUNT] = {
+    "SW_5", "SW_6", "SW_7", "SW_10", "SW_11", "SW_12",
+    "SW_13", "SW_14", "SW_15", "SW_16", "SW_17"
+};
+
+static volatile bool inputs[INPUT_COUNT];
+static volatile bool leds[LED_COUNT];
+static char seg7[8];
+static volatile uint32_t shift_reg;
+
+static SimEvent_t events[SIM_MAX_EVENTS];
+static int n_events;
+static TickType_t run_ticks = 60000;
+static uint32_t laps_wanted;
+static volatile uint32_t laps;
+static bool verbose;
+static TaskHandle_t xSim_handle;
+static void (*input_irq)(void);
+static volatile uint32_t input_change_us;
+
+static double wall_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static int input_by_name(const char *name) {
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        if (strcmp(name, input_names[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void load_script(const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[128];
+    char name[16];
+    unsigned long t;
+    int level;
+
+    if (f == NULL) {
+        fprintf(stderr, "sim: cannot open script %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    while (fgets(line, sizeof(line), f) != NULL && n_events < SIM_MAX_EVENTS) {
+        if (line[0] == '#' || sscanf(line, "%lu %15s %d", &t, name, &level) != 3)
+            continue;
+        int pin = input_by_name(name);
+        if (pin < 0) {
+            fprintf(stderr, "sim: unknown input %s\n", name);
+            continue;
+        }
+        events[n_events].time  = (TickType_t) t;
+        events[n_events].pin   = (Input_t) pin;
+        events[n_events].level = level != 0;
+        n_events++;
+    }
+    fclose(f);
+}
+
+/* Replays the script and ends the run. Runs above all application tasks
+ * so that inputs change exactly at the scripted tick. */
+static void vSimTask(void *args) {
+    TickType_t xNow;
+    TickType_t xWake;
+    int next = 0;
+    double start = wall_ms();
+
+    (void) args;
+    for (;;) {
+        xNow = xTaskGetTickCount();
+        while (next < n_events && events[next].time <= xNow) {
+            SIM_SetInput(events[next].pin, events[next].level);
+            next++;
+        }
+        if (xNow >= run_ticks || (laps_wanted != 0 && laps >= laps_wanted))
+            break;
+
+        xWake = run_ticks;
+        if (next < n_events && events[next].time < xWake)
+            xWake = events[next].time;
+        ulTaskNotifyTake(pdTRUE, xWake - xNow);
+    }
+
+    printf("sim: %lu ticks in %.1f ms wall time, %lu laps, 7seg \"%s\"\n",
+           (unsigned long) xTaskGetTickCount(), wall_ms() - start,
+           (unsigned long) laps, seg7);
+    fflush(stdout);
+    exit(EXIT_SUCCESS);
+}
+
+void BSP_Init(void) {
+    const char *env;
+
+    /* Let the port's tick thread sleep for microseconds, not 50 us. */
+    prctl(PR_SET_TIMERSLACK, 1UL);
+
+    /* Pedals and cruise button are pull-up (released = 1),
+     * the load switches SW_10..SW_17 start in the off position. */
+    for (int i = 0; i < INPUT_COUNT; i++)
+        inputs[i] = i < SW_10;
+
+    if ((env = getenv("SIM_SCRIPT")) != NULL)
+        load_script(env);
+    if ((env = getenv("SIM_RUN_MS")) != NULL)
+        run_ticks = pdMS_TO_TICKS(strtoul(env, NULL, 10));
+    if ((env = getenv("SIM_LAPS")) != NULL)
+        laps_wanted = strtoul(env, NULL, 10);
+    verbose = getenv("SIM_VERBOSE") != NULL;
+
+#if configSUPPORT_DYNAMIC_ALLOCATION
+    xTaskCreate(vSimTask, "Sim Task", configMINIMAL_STACK_SIZE, NULL,
+                SIM_TASK_PRIORITY, &xSim_handle);
+#else
+    /* STATIC_ALLOC: not part of the application's arena (mem.h) */
+    static StaticTask_t xSimTCB;
+    static StackType_t xSimStack[configMINIMAL_STACK_SIZE];
+
+    xSim_handle = xTaskCreateStatic(vSimTask, "Sim Task", configMINIMAL_STACK_SIZE, NULL,
+                                    SIM_TASK_PRIORITY, xSimStack, &xSimTCB);
+#endif
+}
+
+bool BSP_GetInput(Input_t pin) {
+    return inputs[pin];
+}
+
+void BSP_SetLED(LED_t led, bool value) {
+    if (verbose && leds[led] != value)
+        printf("[%6lu] LED %d = %d\n", (unsigned long) xTaskGetTickCount(), led, value);
+    leds[led] = value;
+}
+
+void BSP_ToggleLED(LED_t led) {
+    BSP_SetLED(led, !leds[led]);
+}
+
+void BSP_7SegClear(void) {
+    seg7[0] = '\0';
+}
+
+void BSP_7SegBrightness(uint8_t level) {
+    (void) level;
+}
+
+void BSP_7SegDispString(const char *str) {
+    strncpy(seg7, str, sizeof(seg7) - 1);
+    if (verbose)
+        printf("[%6lu] 7SEG %s\n", (unsigned long) xTaskGetTickCount(), seg7);
+}
+
+/* The display task lights one of the 24 LEDs per 1000 position units,
+ * so a wrap from a high LED back to LED 0 marks a completed lap. */
+void BSP_ShiftRegWriteAll(const uint8_t *data) {
+    uint32_t value = data[0] | (data[1] << 8) | ((uint32_t) data[2] << 16);
+
+    if (value < shift_reg && value == 1) {
+        laps++;
+        if (laps_wanted != 0 && laps >= laps_wanted)
+            xTaskNotifyGive(xSim_handle);
+    }
+    shift_reg = value;
+}
+
+void sleep_ms(uint32_t ms) {
+    usleep(ms * 1000 / SIM_TICKS_PER_WALL_MS);
+}
+
+void SIM_SetInput(Input_t pin, bool level) {
+    if (verbose)
+        printf("[%6lu] %s = %d\n", (unsigned long) xTaskGetTickCount(), input_names[pin], level);
+    if (inputs[pin] == level)
+        return;
+    inputs[pin] = level;
+    input_change_us = SIM_ClockUs();
+    if (input_irq != NULL)
+        input_irq();
+}
+
+uint32_t SIM_ReadInputs(void) {
+    uint32_t port = 0;
+
+    for (int i = 0; i < INPUT_COUNT; i++)
+        port |= (uint32_t) inputs[i] << i;
+    return port;
+}
+
+void SIM_SetInputIrq(void (*callback)(void)) {
+    input_irq = callback;
+}
+
+uint32_t SIM_ClockUs(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) ((ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000) * SIM_TICKS_PER_WALL_MS);
+}
+
+uint32_t SIM_GetInputChangeUs(void) {
+    return input_change_us;
+}
+
+bool SIM_GetLED(LED_t led) {
+    return leds[led];
+}
+
+const char *SIM_Get7Seg(void) {
+    return seg7;
+}
+
+uint32_t SIM_GetShiftReg(void) {
+    return shift_reg;
+}
+
+void vAssertCalled(const char * const pcFileName, unsigned long ulLine) {
+    fprintf(stderr, "sim: assert failed at %s:%lu\n", pcFileName, ulLine);
+    abort();
+}
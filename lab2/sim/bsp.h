@@ -0,0 +1,68 @@
+/**
+ * @file bsp.h
+ * @brief Host stand-in for the ES Lab-Kit board support package.
+ *
+ *        Provides the subset of the BSP used by the lab2 programs.
+ *        Inputs are driven by SIM_SetInput() or by a script file,
+ *        outputs are kept in memory and can be echoed to stdout.
+ *        Pedals and the cruise button use the board's pull-up
+ *        convention: pressed reads 0.
+ */
+#ifndef SIM_BSP_H
+#define SIM_BSP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    LED_RED = 0,
+    LED_YELLOW,
+    LED_GREEN,
+    LED_COUNT
+} LED_t;
+
+typedef enum {
+    SW_5 = 0,
+    SW_6,
+    SW_7,
+    SW_10,
+    SW_11,
+    SW_12,
+    SW_13,
+    SW_14,
+    SW_15,
+    SW_16,
+    SW_17,
+    INPUT_COUNT
+} Input_t;
+
+void BSP_Init(void);
+
+bool BSP_GetInput(Input_t pin);
+void BSP_SetLED(LED_t led, bool value);
+void BSP_ToggleLED(LED_t led);
+
+void BSP_7SegClear(void);
+void BSP_7SegBrightness(uint8_t level);
+void BSP_7SegDispString(const char *str);
+
+void BSP_ShiftRegWriteAll(const uint8_t *data);
+
+void sleep_ms(uint32_t ms);
+
+/* Simulation controls (host build only) */
+void SIM_SetInput(Input_t pin, bool level);
+bool SIM_GetLED(LED_t led);
+const char *SIM_Get7Seg(void);
+uint32_t SIM_GetShiftReg(void);
+
+/* All inputs in one word, bit n is input n: the host's "port read". */
+uint32_t SIM_ReadInputs(void);
+/* Called on every input change, like a GPIO edge interrupt. */
+void SIM_SetInputIrq(void (*callback)(void));
+/* Simulated microseconds, SIM_TICKS_PER_WALL_MS times wall-clock time. */
+uint32_t SIM_ClockUs(void);
+/* SIM_ClockUs() of the last input change. */
+uint32_t SIM_GetInputChangeUs(void);
+
+#endif /* SIM_BSP_H */
@@ -0,0 +1,9 @@
+/**
+ * @file clocks.h
+ * @brief Empty stand-in for the pico-sdk clocks header so that the
+ *        lab2 sources compile unchanged in the host build.
+ */
+#ifndef SIM_HARDWARE_CLOCKS_H
+#define SIM_HARDWARE_CLOCKS_H
+
+#endif /* SIM_HARDWARE_CLOCKS_H */
@@ -0,0 +1,37 @@
+/**
+ * @file slope.c
+ * @brief Simulated accelerometer and slope estimation, see slope.h.
+ */
+#include "vehicle.h"
+#include "slope.h"
+
+ImuSample_t imu_sample(int8_t acceleration, int16_t thrust, bool brake,
+                       uint16_t velocity, uint16_t new_velocity, uint16_t *noise) {
+    ImuSample_t sample;
+    uint16_t x = *noise;
+
+    // xorshift16: uniform noise in [-IMU_NOISE, IMU_NOISE]
+    x ^= x << 7;
+    x ^= x >> 9;
+    x ^= x << 8;
+    *noise = x;
+
+    sample.accel = (int16_t) (acceleration + (int32_t) (x % (2 * IMU_NOISE + 1)) - IMU_NOISE);
+    sample.model = (int16_t) (thrust - wind_retardation(velocity));
+    sample.valid = !brake && new_velocity > 0;
+    return sample;
+}
+
+void slope_init(SlopeFilter_t *filter) {
+    filter->slope_q8 = 0;
+}
+
+int16_t slope_update(SlopeFilter_t *filter, const ImuSample_t *sample) {
+    int32_t raw;
+
+    if (sample->valid) {
+        raw = (int32_t) sample->model - sample->accel;
+        filter->slope_q8 += (raw * 256 - filter->slope_q8) >> SLOPE_FILTER_SHIFT;
+    }
+    return (int16_t) ((filter->slope_q8 + 128) >> 8);
+}
@@ -0,0 +1,55 @@
+/**
+ * @file slope.h
+ * @brief Simulated accelerometer and slope (terrain) estimation.
+ *
+ *        The vehicle model predicts the acceleration on even ground from
+ *        the engine thrust and the wind at the current velocity. The
+ *        acceleration the car actually has falls short of it by the
+ *        slope, so the filter low-pass filters model minus measured
+ *        acceleration, a first-order IIR in Q8 with one shift per
+ *        sample. The estimate is in the units of the terrain retardation
+ *        of vehicle.c (0.1 m/s^2) and replaces the terrain map in the
+ *        feed-forward of the cruise control law (CONTROLLER_TERRAIN_FF,
+ *        controller.h).
+ *
+ *        The Lab-Kit has no accelerometer on the simulated car, so
+ *        imu_sample() takes the acceleration the plant applied over the
+ *        step of the Vehicle task and adds pseudo-random vibration
+ *        noise, on the target as in the host tools. It never reads the
+ *        terrain map. Steps with the brake on or at standstill, where the
+ *        plant ignores the forces, are not used.
+ *
+ *        Plain C without FreeRTOS, like vehicle.c.
+ */
+#ifndef SLOPE_H
+#define SLOPE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define IMU_NOISE           4   /* +-0.4 m/s^2 of vibration */
+#define SLOPE_FILTER_SHIFT  1   /* IIR weight of a new sample: 1/2 */
+
+typedef struct {
+    int16_t accel;      /* measured acceleration, 0.1 m/s^2 */
+    int16_t model;      /* predicted on even ground, 0.1 m/s^2 */
+    bool    valid;      /* the forces drove the step */
+} ImuSample_t;
+
+typedef struct {
+    int32_t slope_q8;
+} SlopeFilter_t;
+
+/* Reading of one Vehicle step: acceleration is what the plant applied,
+ * thrust the engine's share of it (drive / 2, gearbox.h), velocity the
+ * velocity before the step and new_velocity after it. *noise is the
+ * generator state, any value but 0 as seed. */
+ImuSample_t imu_sample(int8_t acceleration, int16_t thrust, bool brake,
+                       uint16_t velocity, uint16_t new_velocity, uint16_t *noise);
+
+void slope_init(SlopeFilter_t *filter);
+
+/* One sample; returns the slope estimate (terrain retardation). */
+int16_t slope_update(SlopeFilter_t *filter, const ImuSample_t *sample);
+
+#endif /* SLOPE_H */
@@ -0,0 +1,74 @@
+/**
+ * @file stack_sizes.h
+ * @brief Stack depth (words) of every application task.
+ *
+ *        All default to TASK_STACK_SIZE. With STACK_SIZES_MEASURED = 1
+ *        the "#define STACK_<NAME>" lines printed by the memory map
+ *        (mem.h) of a run on the same target, saved as
+ *        stack_sizes_measured.h, override them.
+ */
+#ifndef STACK_SIZES_H
+#define STACK_SIZES_H
+
+#ifndef TASK_STACK_SIZE
+#define TASK_STACK_SIZE 512 /* Stack depth (words) of every task, the host build needs more */
+#endif
+
+#ifndef STACK_SIZES_MEASURED
+#define STACK_SIZES_MEASURED 0
+#endif
+
+#if STACK_SIZES_MEASURED
+#include "stack_sizes_measured.h"
+#endif
+
+#ifndef STACK_BUTTON_TASK
+#define STACK_BUTTON_TASK              TASK_STACK_SIZE
+#endif
+#ifndef STACK_VEHICLE_TASK
+#define STACK_VEHICLE_TASK             TASK_STACK_SIZE
+#endif
+#ifndef STACK_CONTROL_TASK
+#define STACK_CONTROL_TASK             TASK_STACK_SIZE
+#endif
+#ifndef STACK_DISPLAY_TASK
+#define STACK_DISPLAY_TASK             TASK_STACK_SIZE
+#endif
+#ifndef STACK_WATCHDOG_TASK
+#define STACK_WATCHDOG_TASK            TASK_STACK_SIZE
+#endif
+#ifndef STACK_OVERLOADDETECTION_TASK
+#define STACK_OVERLOADDETECTION_TASK   TASK_STACK_SIZE
+#endif
+#ifndef STACK_EXTRALOAD_TASK
+#define STACK_EXTRALOAD_TASK           TASK_STACK_SIZE
+#endif
+#ifndef STACK_OVERLOAD_TASK
+#define STACK_OVERLOAD_TASK            TASK_STACK_SIZE
+#endif
+#ifndef STACK_LOG_DRAIN_TASK
+#define STACK_LOG_DRAIN_TASK           TASK_STACK_SIZE
+#endif
+#ifndef STACK_RUNSTATS_TASK
+#define STACK_RUNSTATS_TASK            TASK_STACK_SIZE
+#endif
+#ifndef STACK_TRACE_DUMP_TASK
+#define STACK_TRACE_DUMP_TASK          TASK_STACK_SIZE
+#endif
+#ifndef STACK_BUS_BENCH_TASK
+#define STACK_BUS_BENCH_TASK           TASK_STACK_SIZE
+#endif
+#ifndef STACK_MEMMAP_TASK
+#define STACK_MEMMAP_TASK              TASK_STACK_SIZE
+#endif
+#ifndef STACK_GEARBOX_TASK
+#define STACK_GEARBOX_TASK             TASK_STACK_SIZE
+#endif
+#ifndef STACK_SLOPE_TASK
+#define STACK_SLOPE_TASK               TASK_STACK_SIZE
+#endif
+#ifndef STACK_LOAD_SWEEP_TASK
+#define STACK_LOAD_SWEEP_TASK          TASK_STACK_SIZE
+#endif
+
+#endif /* STACK_SIZES_H */
@@ -0,0 +1,218 @@
+/**
+ * @file state_bus.c
+ * @brief Shared state of the cruise control tasks, see state_bus.h.
+ */
+#include <stdio.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "trace.h"
+#include "mem.h"
+#include "state_bus.h"
+
+#if !STATE_BUS_QUEUES
+
+static CruiseState_t state;
+static volatile uint32_t sequence;
+static volatile uint32_t retries;
+
+/* Odd sequence: a publish is in progress. */
+#define BUS_WRITE_BEGIN()   taskENTER_CRITICAL();                       \
+                            sequence = sequence + 1;                    \
+                            __atomic_thread_fence(__ATOMIC_RELEASE)
+#define BUS_WRITE_END()     __atomic_thread_fence(__ATOMIC_RELEASE);    \
+                            sequence = sequence + 1;                    \
+                            taskEXIT_CRITICAL()
+
+void vBusInit(void) {
+    sequence = 0;
+}
+
+void vBusRead(CruiseState_t *snapshot) {
+    uint32_t seq;
+
+    for (;;) {
+        seq = sequence;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        *snapshot = state;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if ((seq & 1) == 0 && seq == sequence)
+            return;
+        retries++;
+    }
+}
+
+void vBusPublishPedals(bool gas_pedal, bool brake_pedal, bool cruise_control, uint8_t switches) {
+    BUS_WRITE_BEGIN();
+    state.gas_pedal = gas_pedal;
+    state.brake_pedal = brake_pedal;
+    state.cruise_control = cruise_control;
+    state.switches = switches;
+    BUS_WRITE_END();
+}
+
+void vBusPublishVehicle(uint16_t velocity, uint16_t position) {
+    BUS_WRITE_BEGIN();
+    state.velocity = velocity;
+    state.position = position;
+    BUS_WRITE_END();
+}
+
+void vBusPublishThrottle(uint16_t throttle) {
+    BUS_WRITE_BEGIN();
+    state.throttle = throttle;
+    BUS_WRITE_END();
+}
+
+void vBusPublishGear(uint8_t gear) {
+    BUS_WRITE_BEGIN();
+    state.gear = gear;
+    BUS_WRITE_END();
+}
+
+void vBusPublishSlope(int16_t slope) {
+    BUS_WRITE_BEGIN();
+    state.slope = slope;
+    BUS_WRITE_END();
+}
+
+void vBusSetOverloadOk(bool ok) {
+    BUS_WRITE_BEGIN();
+    state.overload_ok = ok;
+    BUS_WRITE_END();
+}
+
+void vBusSetOverloadState(bool overload_state) {
+    BUS_WRITE_BEGIN();
+    state.overload_state = overload_state;
+    BUS_WRITE_END();
+}
+
+uint32_t ulBusRetries(void) {
+    return retries;
+}
+
+#else /* STATE_BUS_QUEUES */
+
+/* The original single-slot overwrite queues. */
+static QueueHandle_t xQueueVelocity;
+static QueueHandle_t xQueuePosition;
+static QueueHandle_t xQueueThrottle;
+static QueueHandle_t xQueueCruiseControl;
+static QueueHandle_t xQueueGasPedal;
+static QueueHandle_t xQueueBrakePedal;
+static QueueHandle_t xQueueOverloadDetected;
+static QueueHandle_t xQueueOverloadState;
+static QueueHandle_t xQueueSwitches;
+static QueueHandle_t xQueueGear;
+static QueueHandle_t xQueueSlope;
+
+void vBusInit(void) {
+    xQueueCruiseControl = xMemQueueCreate( 1, sizeof(bool));
+    xQueueGasPedal      = xMemQueueCreate( 1, sizeof(bool));
+    xQueueBrakePedal    = xMemQueueCreate( 1, sizeof(bool));
+    xQueueVelocity      = xMemQueueCreate( 1, sizeof(uint16_t));
+    xQueuePosition      = xMemQueueCreate( 1, sizeof(uint16_t));
+    xQueueThrottle      = xMemQueueCreate( 1, sizeof(uint16_t));
+
+    xQueueOverloadDetected = xMemQueueCreate( 1, sizeof(bool));
+    xQueueOverloadState = xMemQueueCreate( 1, sizeof(bool));
+    xQueueSwitches      = xMemQueueCreate( 1, sizeof(uint8_t));
+    xQueueGear          = xMemQueueCreate( 1, sizeof(uint8_t));
+    xQueueSlope         = xMemQueueCreate( 1, sizeof(int16_t));
+
+    // Start from the same all-zero state as the bus.
+    vBusPublishPedals(false, false, false, 0);
+    vBusPublishVehicle(0, 0);
+    vBusPublishThrottle(0);
+    vBusPublishGear(0);
+    vBusPublishSlope(0);
+    vBusSetOverloadOk(false);
+    vBusSetOverloadState(false);
+}
+
+void vBusRead(CruiseState_t *snapshot) {
+    xQueuePeek(xQueueGasPedal, &snapshot->gas_pedal, ( TickType_t ) 0);
+    xQueuePeek(xQueueBrakePedal, &snapshot->brake_pedal, ( TickType_t ) 0);
+    xQueuePeek(xQueueCruiseControl, &snapshot->cruise_control, ( TickType_t ) 0);
+    xQueuePeek(xQueueSwitches, &snapshot->switches, ( TickType_t ) 0);
+    xQueuePeek(xQueueVelocity, &snapshot->velocity, ( TickType_t ) 0);
+    xQueuePeek(xQueuePosition, &snapshot->position, ( TickType_t ) 0);
+    xQueuePeek(xQueueThrottle, &snapshot->throttle, ( TickType_t ) 0);
+    xQueuePeek(xQueueGear, &snapshot->gear, ( TickType_t ) 0);
+    xQueuePeek(xQueueSlope, &snapshot->slope, ( TickType_t ) 0);
+    xQueuePeek(xQueueOverloadDetected, &snapshot->overload_ok, ( TickType_t ) 0);
+    xQueuePeek(xQueueOverloadState, &snapshot->overload_state, ( TickType_t ) 0);
+}
+
+void vBusPublishPedals(bool gas_pedal, bool brake_pedal, bool cruise_control, uint8_t switches) {
+    xQueueOverwrite(xQueueGasPedal,     &gas_pedal);
+    xQueueOverwrite(xQueueBrakePedal,   &brake_pedal);
+    xQueueOverwrite(xQueueCruiseControl,&cruise_control);
+    xQueueOverwrite(xQueueSwitches,     &switches);
+}
+
+void vBusPublishVehicle(uint16_t velocity, uint16_t position) {
+    xQueueOverwrite(xQueueVelocity, &velocity);
+    xQueueOverwrite(xQueuePosition, &position);
+}
+
+void vBusPublishThrottle(uint16_t throttle) {
+    xQueueOverwrite(xQueueThrottle, &throttle);
+}
+
+void vBusPublishGear(uint8_t gear) {
+    xQueueOverwrite(xQueueGear, &gear);
+}
+
+void vBusPublishSlope(int16_t slope) {
+    xQueueOverwrite(xQueueSlope, &slope);
+}
+
+void vBusSetOverloadOk(bool ok) {
+    xQueueOverwrite(xQueueOverloadDetected, &ok);
+}
+
+void vBusSetOverloadState(bool overload_state) {
+    xQueueOverwrite(xQueueOverloadState, &overload_state);
+}
+
+uint32_t ulBusRetries(void) {
+    return 0;
+}
+
+#endif /* STATE_BUS_QUEUES */
+
+#if BUS_BENCH
+/* The host clock runs SIM_TICKS_PER_WALL_MS times faster than the CPU. */
+#ifdef SIM_TICKS_PER_WALL_MS
+#define BUS_BENCH_CLOCK_DIV SIM_TICKS_PER_WALL_MS
+#else
+#define BUS_BENCH_CLOCK_DIV 1
+#endif
+
+void vBusBenchTask(void *args) {
+    CruiseState_t snapshot;
+    uint32_t start;
+    uint32_t publish_us;
+    uint32_t read_us;
+
+    (void) args;
+    start = ulTraceClockUs();
+    for (uint32_t i = 0; i < BUS_BENCH_ROUNDS; i++)
+        vBusPublishVehicle((uint16_t) i, (uint16_t) i);
+    publish_us = ulTraceClockUs() - start;
+
+    start = ulTraceClockUs();
+    for (uint32_t i = 0; i < BUS_BENCH_ROUNDS; i++)
+        vBusRead(&snapshot);
+    read_us = ulTraceClockUs() - start;
+
+    printf("--- BUS BENCH (%s) ---\n", STATE_BUS_QUEUES ? "queues" : "seqlock");
+    printf("%d rounds, publish vehicle: %lu ns, read snapshot: %lu ns\n",
+           BUS_BENCH_ROUNDS,
+           (unsigned long) ((uint64_t) publish_us * 1000 / BUS_BENCH_CLOCK_DIV / BUS_BENCH_ROUNDS),
+           (unsigned long) ((uint64_t) read_us * 1000 / BUS_BENCH_CLOCK_DIV / BUS_BENCH_ROUNDS));
+    vMemTaskDelete();
+}
+#endif
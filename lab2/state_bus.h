@@ -0,0 +1,72 @@
+/**
+ * @file state_bus.h
+ * @brief Shared state of the cruise control tasks.
+ *
+ *        Replaces the nine single-slot overwrite queues. All state lives
+ *        in one versioned struct guarded by a sequence lock: a writer
+ *        makes the sequence odd, updates its fields and makes it even
+ *        again; a reader copies the struct and retries if the sequence
+ *        was odd or changed meanwhile. Readers therefore get one
+ *        consistent snapshot of pedals, vehicle and throttle without
+ *        entering the kernel. Writers run at different priorities, so
+ *        a publish is a few stores inside a critical section.
+ *
+ *        STATE_BUS_QUEUES = 1 builds the same interface on the original
+ *        queues, to compare the two with BUS_BENCH.
+ */
+#ifndef STATE_BUS_H
+#define STATE_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef STATE_BUS_QUEUES
+#define STATE_BUS_QUEUES 0
+#endif
+
+#ifndef BUS_BENCH
+#define BUS_BENCH 0     /* 1: time publish/read at startup */
+#endif
+
+#define BUS_BENCH_ROUNDS 10000
+
+typedef struct {
+    /* Button task */
+    bool     gas_pedal;
+    bool     brake_pedal;
+    bool     cruise_control;
+    uint8_t  switches;
+    /* Vehicle task */
+    uint16_t velocity;
+    uint16_t position;
+    /* Control task */
+    uint16_t throttle;
+    /* Gearbox task (gearbox.h), GEAR_NONE without gearbox */
+    uint8_t  gear;
+    /* Slope task (slope.h), terrain retardation estimate */
+    int16_t  slope;
+    /* Watchdog and overload detection */
+    bool     overload_ok;
+    bool     overload_state;
+} CruiseState_t;
+
+void vBusInit(void);
+
+/* Copies a consistent snapshot of the whole state. */
+void vBusRead(CruiseState_t *snapshot);
+
+void vBusPublishPedals(bool gas_pedal, bool brake_pedal, bool cruise_control, uint8_t switches);
+void vBusPublishVehicle(uint16_t velocity, uint16_t position);
+void vBusPublishThrottle(uint16_t throttle);
+void vBusPublishGear(uint8_t gear);
+void vBusPublishSlope(int16_t slope);
+void vBusSetOverloadOk(bool ok);
+void vBusSetOverloadState(bool state);
+
+/* Number of reads that had to retry because of a concurrent publish. */
+uint32_t ulBusRetries(void);
+
+/* BUS_BENCH: one-shot task timing BUS_BENCH_ROUNDS publish/read rounds. */
+void vBusBenchTask(void *args);
+
+#endif /* STATE_BUS_H */
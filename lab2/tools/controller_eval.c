@@ -0,0 +1,217 @@
+/**
+ * @file controller_eval.c
+ * @brief Runs the cruise control law against the plant model of
+ *        vehicle.c for one lap and compares it with the original
+ *        bang-bang law.
+ *
+ *        Vehicle is stepped every 100 ms and Control every 200 ms right
+ *        after it, as the two tasks are released in main.c. The car
+ *        starts at the cruise velocity at position 0. For each terrain
+ *        segment the tool reports the largest error and the settling
+ *        time, i.e. until the velocity stays within +-0.3 m/s of the set
+ *        point, then the RMS error over the lap and the cost of one
+ *        call on the host.
+ *
+ *        The PI(D) runs once per terrain feed-forward source (controller.h):
+ *        none, the slope estimated from the simulated accelerometer
+ *        (slope.h, updated after every Vehicle step) and the terrain map.
+ *
+ *        gcc -O2 -I.. -o controller_eval controller_eval.c ../controller.c \
+ *            ../vehicle.c ../slope.c -lm
+ *        ./controller_eval [cruise velocity ...]
+ *
+ *        Add -DCRUISE_CONTROLLER=2 (and the CONTROLLER_K* gains) to
+ *        evaluate another law, -DBAND=10 for settling to +-1 m/s;
+ *        velocities are in 0.1 m/s.
+ */
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "controller.h"
+#include "vehicle.h"
+#include "slope.h"
+
+#define VEHICLE_PERIOD  100
+#define CONTROL_PERIOD  200
+#define SEGMENT         4000
+#define N_SEGMENTS      (VEHICLE_LAP / SEGMENT)
+#ifndef BAND
+#define BAND            3           /* +-0.3 m/s: the PI(D) stays within +-1 m/s */
+#endif
+#define BENCH_CALLS     10000000
+
+typedef struct {
+    int      max_error[N_SEGMENTS];
+    uint32_t settle_ms[N_SEGMENTS];
+    double   rms_error;
+    uint32_t lap_ms;
+} LapResult_t;
+
+static const char *const law_name[] = { "bang-bang", "PI", "PID" };
+static const char *const terrain_name[] = { "none", "slope", "map" };
+
+static uint16_t control(int law, PidState_t *pid, uint16_t throttle,
+                        uint16_t cruise_velocity, uint16_t velocity, int16_t terrain) {
+    static const PidGains_t gains = PID_GAINS_DEFAULT;
+
+    if (law == 0)
+        return bang_bang_update(throttle, cruise_velocity, velocity);
+    return pid_update(pid, &gains, DRIVE_GAIN_ONE, ELAPSED_ONE, cruise_velocity, velocity, terrain);
+}
+
+/* Terrain term of the feed-forward, as cruise_update() picks it. */
+static int16_t terrain(int terrain_ff, int16_t slope, uint16_t position) {
+    if (terrain_ff == TERRAIN_FF_SLOPE)
+        return slope;
+    if (terrain_ff == TERRAIN_FF_MAP)
+        return terrain_retardation(position);
+    return 0;
+}
+
+static void run_lap(int law, int terrain_ff, uint16_t cruise_velocity, LapResult_t *r) {
+    PidState_t pid;
+    SlopeFilter_t filter;
+    uint16_t noise = 1;
+    int16_t slope = 0;
+    uint16_t position = 0;
+    uint16_t velocity = cruise_velocity;
+    uint16_t throttle;
+    uint32_t entered[N_SEGMENTS] = { 0 };
+    uint32_t last_out[N_SEGMENTS] = { 0 };
+    double sum_sq = 0;
+    uint32_t samples = 0;
+    uint32_t t = 0;
+    int32_t ff = feed_forward(velocity, 0);
+    int segment;
+
+    // Engaged with the throttle that held the set point on even ground.
+    throttle = ff < 0 ? 0 : ff > THROTTLE_MAX ? THROTTLE_MAX : ff;
+    pid_reset(&pid, throttle, DRIVE_GAIN_ONE, velocity, 0);
+    slope_init(&filter);
+
+    for (segment = 0; segment < N_SEGMENTS; segment++) {
+        r->max_error[segment] = 0;
+        r->settle_ms[segment] = 0;
+    }
+
+    while (t < 3600000) {
+        uint16_t last_position = position;
+        uint16_t last_velocity = velocity;
+        bool control_release = t % CONTROL_PERIOD == 0;
+        int8_t acceleration = vehicle_acceleration(throttle, position, velocity);
+        ImuSample_t sample;
+        int error;
+
+        position = adjust_position(position, velocity, acceleration, VEHICLE_PERIOD);
+        velocity = adjust_velocity(velocity, acceleration, false, VEHICLE_PERIOD);
+        t += VEHICLE_PERIOD;
+        sample = imu_sample(acceleration, throttle / 2, false, last_velocity, velocity, &noise);
+        slope = slope_update(&filter, &sample);
+        if (position < last_position)
+            break;                          /* lap completed */
+
+        segment = position / SEGMENT;
+        if (segment >= N_SEGMENTS)
+            segment = N_SEGMENTS - 1;
+        if (entered[segment] == 0)
+            entered[segment] = t;
+
+        error = (int) velocity - cruise_velocity;
+        sum_sq += (double) error * error;
+        samples++;
+        if (abs(error) > abs(r->max_error[segment]))
+            r->max_error[segment] = error;
+        if (abs(error) > BAND)
+            last_out[segment] = t;
+
+        if (control_release)
+            throttle = control(law, &pid, throttle, cruise_velocity, velocity,
+                               terrain(terrain_ff, slope, position));
+    }
+
+    for (segment = 0; segment < N_SEGMENTS; segment++) {
+        if (last_out[segment] != 0)
+            r->settle_ms[segment] = last_out[segment] + VEHICLE_PERIOD - entered[segment];
+    }
+    r->rms_error = samples ? sqrt(sum_sq / samples) : 0;
+    r->lap_ms = t;
+}
+
+static double ns_per_call(int law) {
+    PidState_t pid = { 0, 300 };
+    struct timespec t0, t1;
+    volatile uint16_t sink = 0;
+    uint16_t throttle = 40;
+    uint32_t i;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < BENCH_CALLS; i++) {
+        throttle = control(law, &pid, throttle, 300, 280 + (i & 63),
+                           terrain_retardation(i % VEHICLE_LAP));
+        sink += throttle;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    (void) sink;
+    return ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / BENCH_CALLS;
+}
+
+static double ns_per_sample(void) {
+    SlopeFilter_t filter;
+    struct timespec t0, t1;
+    volatile int16_t sink = 0;
+    ImuSample_t sample;
+    uint32_t i;
+
+    slope_init(&filter);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < BENCH_CALLS; i++) {
+        sample.accel = (int16_t) (i & 31) - 16;
+        sample.model = 0;
+        sample.valid = true;
+        sink += slope_update(&filter, &sample);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    (void) sink;
+    return ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / BENCH_CALLS;
+}
+
+int main(int argc, char *argv[]) {
+    static const uint16_t default_velocities[] = { 250, 400, 550 };
+    const int laws[] = { 0, CRUISE_CONTROLLER };
+    int n_laws = CRUISE_CONTROLLER == 0 ? 1 : 2;
+    int n = argc > 1 ? argc - 1 : 3;
+    int i, l, f, s;
+
+    printf("settle ms / max error per segment (0.1 m/s), band +-%d\n", BAND);
+    printf("%-9s %5s", "law", "set");
+    for (s = 0; s < N_SEGMENTS; s++)
+        printf("  %5d-%-5d ", s * SEGMENT, (s + 1) * SEGMENT);
+    printf("  %6s %7s\n", "rms", "lap s");
+
+    for (i = 0; i < n; i++) {
+        uint16_t v = argc > 1 ? (uint16_t) atoi(argv[i + 1]) : default_velocities[i];
+
+        for (l = 0; l < n_laws; l++) {
+            // Bang-bang has no feed-forward: one row.
+            for (f = laws[l] == 0 ? TERRAIN_FF_MAP : TERRAIN_FF_NONE; f <= TERRAIN_FF_MAP; f++) {
+                char name[16];
+                LapResult_t r;
+
+                run_lap(laws[l], f, v, &r);
+                snprintf(name, sizeof(name), laws[l] == 0 ? "%s" : "%s/%s",
+                         law_name[laws[l]], terrain_name[f]);
+                printf("%-9s %5u", name, v);
+                for (s = 0; s < N_SEGMENTS; s++)
+                    printf("  %5u/%-+5d ", r.settle_ms[s], r.max_error[s]);
+                printf("  %6.1f %7.1f\n", r.rms_error, r.lap_ms / 1000.0);
+            }
+        }
+    }
+
+    for (l = 0; l < n_laws; l++)
+        printf("%-9s %.1f ns per call\n", law_name[laws[l]], ns_per_call(laws[l]));
+    printf("%-9s %.1f ns per sample\n", "slope", ns_per_sample());
+    return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file logdecode.c
+ * @brief Host decoder for the binary deferred log (LOG_BINARY = 1).
+ *
+ *        Reads the serial stream on stdin and prints the records as
+ *        text, prefixed with the tick they were written at:
+ *
+ *        gcc -I.. -o logdecode logdecode.c
+ *        ./logdecode < /dev/ttyACM0
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include "log.h"
+
+#define LOG_ID(name, nargs, fmt) fmt,
+static const char *const log_format[LOG_ID_COUNT] = {
+#include "log_ids.h"
+};
+#undef LOG_ID
+
+static int read_u32(uint32_t *value) {
+    uint8_t b[4];
+
+    if (fread(b, 1, 4, stdin) != 4)
+        return 0;
+    *value = b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t) b[3] << 24);
+    return 1;
+}
+
+int main(void) {
+    int c;
+    int id, nargs;
+    uint32_t tick;
+    uint32_t args[LOG_MAX_ARGS];
+
+    while ((c = getchar()) != EOF) {
+        if (c != LOG_FRAME_SYNC)
+            continue;   /* resynchronise on the next frame */
+        id = getchar();
+        nargs = getchar();
+        if (id == EOF || nargs == EOF)
+            break;
+        if (id >= LOG_ID_COUNT || nargs > LOG_MAX_ARGS)
+            continue;
+        if (!read_u32(&tick))
+            break;
+        for (int i = 0; i < LOG_MAX_ARGS; i++)
+            args[i] = 0;
+        for (int i = 0; i < nargs; i++) {
+            if (!read_u32(&args[i]))
+                return 0;
+        }
+        printf("[%6lu] ", (unsigned long) tick);
+        printf(log_format[id], (int32_t) args[0], (int32_t) args[1], (int32_t) args[2]);
+    }
+    return 0;
+}
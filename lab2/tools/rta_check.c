@@ -0,0 +1,43 @@
+/**
+ * @file rta_check.c
+ * @brief Host front end of the response-time analysis in rta.c.
+ *
+ *        Reads a task set, one task per line:
+ *            <name> <period ms> <deadline ms> <wcet us> <blocking us> <priority>
+ *        and exits with 1 if it is not schedulable.
+ *
+ *        gcc -I.. -o rta_check rta_check.c ../rta.c
+ *        ./rta_check taskset.txt
+ */
+#include <stdio.h>
+#include <string.h>
+#include "rta.h"
+
+int main(int argc, char *argv[]) {
+    static char names[RTA_MAX_TASKS][32];
+    RtaTask_t set[RTA_MAX_TASKS];
+    unsigned long period, deadline, wcet, blocking;
+    unsigned prio;
+    char line[128];
+    int n = 0;
+    FILE *f = argc > 1 ? fopen(argv[1], "r") : stdin;
+
+    if (f == NULL) {
+        perror(argv[1]);
+        return 2;
+    }
+    while (fgets(line, sizeof(line), f) != NULL && n < RTA_MAX_TASKS) {
+        if (line[0] == '#'
+            || sscanf(line, "%31s %lu %lu %lu %lu %u", names[n], &period,
+                      &deadline, &wcet, &blocking, &prio) != 6)
+            continue;
+        set[n].name        = names[n];
+        set[n].period_us   = period * 1000;
+        set[n].deadline_us = deadline * 1000;
+        set[n].wcet_us     = wcet;
+        set[n].blocking_us = blocking;
+        set[n].priority    = prio;
+        n++;
+    }
+    return xRtaCheck(set, n, true) ? 0 : 1;
+}
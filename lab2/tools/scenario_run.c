@@ -0,0 +1,233 @@
+/**
+ * @file scenario_run.c
+ * @brief Batch runner for the plant simulator (plant_sim.h).
+ *
+ *        Runs every combination of the given input scripts, control
+ *        laws, gains and task periods on all cores and prints one CSV
+ *        line per scenario. With -t each scenario also writes its
+ *        trace (velocity, error, throttle per Vehicle step) to
+ *        <dir>/scenario_<id>.csv.
+ *
+ *        gcc -O2 -I.. -o scenario_run scenario_run.c ../plant_sim.c \
+ *            ../controller.c ../vehicle.c ../gearbox.c ../slope.c -lpthread -lm
+ *        ./scenario_run -l 0,1 -p 1:4:0.5 -i 0.25,0.5 ../sim/cruise.txt > sweep.csv
+ *
+ *        Lists are comma separated values or first:last:step ranges;
+ *        gains are in throttle per unit of velocity (0.1 m/s) and are
+ *        converted to the Q16 gains of controller.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "plant_sim.h"
+
+#define MAX_VALUES  64
+#define MAX_SCRIPTS 64
+
+typedef struct {
+    double value[MAX_VALUES];
+    int    n;
+} List_t;
+
+typedef struct {
+    int             script;
+    PlantScenario_t sc;
+    PlantResult_t   result;
+} Job_t;
+
+typedef struct {
+    Job_t       *jobs;
+    int          n_jobs;
+    atomic_int   next;
+    const char  *trace_dir;
+} Batch_t;
+
+static const char *scripts[MAX_SCRIPTS];
+static PlantEvent_t *script_events[MAX_SCRIPTS];
+static int script_n_events[MAX_SCRIPTS];
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [options] script...\n"
+            "  -j n       threads (default: all cores)\n"
+            "  -d ms      simulated time per scenario (default 100000)\n"
+            "  -l list    control laws, 0 bang-bang 1 PI 2 PID (default CRUISE_CONTROLLER)\n"
+            "  -p list    proportional gains\n"
+            "  -i list    integral gains\n"
+            "  -D list    derivative gains\n"
+            "  -c list    Control periods in ms (default 200)\n"
+            "  -v list    Vehicle periods in ms (default 100)\n"
+            "  -g         automatic gearbox (gearbox.h)\n"
+            "  -T n       terrain feed-forward, 0 none 1 slope 2 map (controller.h)\n"
+            "  -t dir     write a trace CSV per scenario to dir\n", prog);
+    exit(2);
+}
+
+static void parse_list(const char *arg, List_t *list) {
+    char *copy = strdup(arg);
+    char *tok;
+
+    list->n = 0;
+    for (tok = strtok(copy, ","); tok != NULL; tok = strtok(NULL, ",")) {
+        double first, last, step, v;
+
+        if (sscanf(tok, "%lf:%lf:%lf", &first, &last, &step) == 3 && step > 0) {
+            for (v = first; v <= last + step / 1e6 && list->n < MAX_VALUES; v += step)
+                list->value[list->n++] = v;
+        } else if (list->n < MAX_VALUES) {
+            list->value[list->n++] = atof(tok);
+        }
+    }
+    free(copy);
+}
+
+static void single(List_t *list, double value) {
+    list->value[0] = value;
+    list->n = 1;
+}
+
+static void write_sample(void *ctx, const PlantSample_t *s) {
+    fprintf((FILE *) ctx, "%u,%u,%u,%d,%u,%u,%u\n", s->t_ms, s->position, s->velocity,
+            s->state == CRUISE_ACTIVE ? (int) s->velocity - s->cruise_velocity : 0,
+            s->throttle, s->state, s->gear);
+}
+
+static void *worker(void *arg) {
+    Batch_t *batch = arg;
+    int id;
+
+    while ((id = atomic_fetch_add(&batch->next, 1)) < batch->n_jobs) {
+        Job_t *job = &batch->jobs[id];
+        FILE *trace = NULL;
+
+        job->sc.events = script_events[job->script];
+        job->sc.n_events = script_n_events[job->script];
+        if (batch->trace_dir != NULL) {
+            char path[512];
+
+            snprintf(path, sizeof(path), "%s/scenario_%d.csv", batch->trace_dir, id);
+            trace = fopen(path, "w");
+            if (trace == NULL)
+                perror(path);
+            else
+                fprintf(trace, "t_ms,position,velocity,error,throttle,state,gear\n");
+        }
+        plant_run(&job->sc, &job->result, trace ? write_sample : NULL, trace);
+        if (trace != NULL)
+            fclose(trace);
+    }
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    PlantScenario_t base;
+    List_t laws, kp, ki, kd, control, vehicle;
+    Batch_t batch = { 0 };
+    pthread_t *threads;
+    struct timespec t0, t1;
+    long n_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int n_scripts;
+    int opt, s, a, b, c, d, e, f, k;
+    double elapsed;
+
+    plant_scenario_default(&base);
+    single(&laws, base.law);
+    single(&kp, base.gains.kp / 65536.0);
+    single(&ki, base.gains.ki / 65536.0);
+    single(&kd, base.gains.kd / 65536.0);
+    single(&control, base.control_period);
+    single(&vehicle, base.vehicle_period);
+
+    while ((opt = getopt(argc, argv, "j:d:l:p:i:D:c:v:gT:t:")) != -1) {
+        switch (opt) {
+        case 'j': n_threads = atol(optarg); break;
+        case 'd': base.duration_ms = strtoul(optarg, NULL, 10); break;
+        case 'l': parse_list(optarg, &laws); break;
+        case 'p': parse_list(optarg, &kp); break;
+        case 'i': parse_list(optarg, &ki); break;
+        case 'D': parse_list(optarg, &kd); break;
+        case 'c': parse_list(optarg, &control); break;
+        case 'v': parse_list(optarg, &vehicle); break;
+        case 'g': base.gearbox = true; break;
+        case 'T': base.terrain_ff = (uint8_t) atoi(optarg); break;
+        case 't': batch.trace_dir = optarg; break;
+        default: usage(argv[0]);
+        }
+    }
+    n_scripts = argc - optind;
+    if (n_scripts < 1 || n_scripts > MAX_SCRIPTS || n_threads < 1)
+        usage(argv[0]);
+
+    for (s = 0; s < n_scripts; s++) {
+        scripts[s] = argv[optind + s];
+        script_n_events[s] = plant_load_events(scripts[s], &script_events[s]);
+        if (script_n_events[s] < 0) {
+            perror(scripts[s]);
+            return 1;
+        }
+    }
+
+    batch.n_jobs = n_scripts * laws.n * kp.n * ki.n * kd.n * control.n * vehicle.n;
+    batch.jobs = calloc(batch.n_jobs, sizeof(Job_t));
+    if (batch.jobs == NULL)
+        return 1;
+    k = 0;
+    for (s = 0; s < n_scripts; s++)
+     for (a = 0; a < laws.n; a++)
+      for (b = 0; b < kp.n; b++)
+       for (c = 0; c < ki.n; c++)
+        for (d = 0; d < kd.n; d++)
+         for (e = 0; e < control.n; e++)
+          for (f = 0; f < vehicle.n; f++) {
+            Job_t *job = &batch.jobs[k++];
+
+            job->script = s;
+            job->sc = base;
+            job->sc.law = (uint8_t) laws.value[a];
+            job->sc.gains.kp = (int32_t) (kp.value[b] * 65536.0 + 0.5);
+            job->sc.gains.ki = (int32_t) (ki.value[c] * 65536.0 + 0.5);
+            job->sc.gains.kd = (int32_t) (kd.value[d] * 65536.0 + 0.5);
+            job->sc.control_period = (uint16_t) control.value[e];
+            job->sc.vehicle_period = (uint16_t) vehicle.value[f];
+            if (job->sc.control_period == 0 || job->sc.vehicle_period == 0)
+                usage(argv[0]);
+          }
+
+    if (n_threads > batch.n_jobs)
+        n_threads = batch.n_jobs;
+    threads = calloc(n_threads, sizeof(pthread_t));
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (k = 0; k < n_threads; k++)
+        pthread_create(&threads[k], NULL, worker, &batch);
+    for (k = 0; k < n_threads; k++)
+        pthread_join(threads[k], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    elapsed = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    // Printed after the run, in scenario order, so the output does not
+    // depend on the number of threads.
+    printf("id,script,law,kp,ki,kd,vehicle_ms,control_ms,active_ms,max_error,rms_error,"
+           "throttle_changes,final_velocity,shifts\n");
+    for (k = 0; k < batch.n_jobs; k++) {
+        const Job_t *job = &batch.jobs[k];
+
+        printf("%d,%s,%u,%.4f,%.4f,%.4f,%u,%u,%u,%d,%.2f,%u,%u,%u\n", k, scripts[job->script],
+               job->sc.law, job->sc.gains.kp / 65536.0, job->sc.gains.ki / 65536.0,
+               job->sc.gains.kd / 65536.0, job->sc.vehicle_period, job->sc.control_period,
+               job->result.active_samples * job->sc.vehicle_period, job->result.max_error,
+               job->result.rms_error, job->result.throttle_changes,
+               job->result.final_velocity, job->result.shifts);
+    }
+    fprintf(stderr, "%d scenarios in %.3f s (%.0f per second) on %ld threads\n",
+            batch.n_jobs, elapsed, batch.n_jobs / elapsed, n_threads);
+
+    for (s = 0; s < n_scripts; s++)
+        free(script_events[s]);
+    free(batch.jobs);
+    free(threads);
+    return 0;
+}
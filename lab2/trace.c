@@ -0,0 +1,390 @@
+/**
+ * @file trace.c
+ * @brief Per-job timing trace for the lab2 periodic tasks, see trace.h.
+ *
+ *        The ready and switch hooks run inside the kernel (context
+ *        switch, tick ISR or with the scheduler suspended), which on the
+ *        single-core Lab-Kit never nest. The delay-until hook runs at
+ *        the start of xTaskDelayUntil() in task context, where an ISR
+ *        can make a task ready, so it masks interrupts while it writes.
+ *        The ring buffer thus has one writer at a time.
+ *
+ *        With SMP the kernel calls the ready and switch hooks holding
+ *        at least its ISR lock. The delay-until hook runs unlocked on
+ *        its own core, but its taskENTER_CRITICAL() takes the task and
+ *        ISR locks, which excludes the hooks of the other core too.
+ *        The writer never waits: when the buffer is full the event is
+ *        dropped and counted.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace.h"
+
+#ifdef SIM_TICKS_PER_WALL_MS
+#include "bsp.h"
+#else
+#include "hardware/timer.h"
+#endif
+
+#define TRACE_US_PER_TICK   1000    /* one tick is one millisecond */
+
+typedef enum {
+    JOB_WAITING = 0,    /* blocked until the next release */
+    JOB_READY,          /* released, not yet started */
+    JOB_RUNNING,
+    JOB_PREEMPTED
+} JobState_t;
+
+typedef struct {
+    uint32_t min, max;
+    uint64_t sum;
+} TraceStat_t;
+
+typedef struct {
+    const char *name;
+    JobState_t  state;
+    uint32_t    next_release;   /* tick of the next nominal release */
+    uint32_t    release_tick;
+    uint32_t    release_us;
+    uint32_t    last_in_us;     /* last switch in */
+    uint32_t    exec_us;        /* execution time of the current job */
+    uint32_t    jobs;
+    uint32_t    preemptions;
+    TraceStat_t c;              /* execution time */
+    TraceStat_t r;              /* response time */
+    TraceStat_t s;              /* start latency (release jitter) */
+} TraceTask_t;
+
+static TraceTask_t tasks[TRACE_MAX_TASKS];
+static uint8_t n_tasks;
+
+static TraceEvent_t ring[TRACE_BUFFER_SIZE];
+static volatile uint32_t ring_head;     /* written by the hooks only */
+static volatile uint32_t ring_tail;     /* written by the reader only */
+static volatile uint32_t ring_dropped;
+
+uint32_t ulTraceClockUs(void) {
+#ifdef SIM_TICKS_PER_WALL_MS
+    return SIM_ClockUs();
+#else
+    return time_us_32();
+#endif
+}
+
+static void put_event(uint8_t task, TraceEventType_t type, uint32_t time_us) {
+    uint32_t head = ring_head;
+
+    if (head - ring_tail >= TRACE_BUFFER_SIZE) {
+        ring_dropped++;
+        return;
+    }
+    ring[head & (TRACE_BUFFER_SIZE - 1)].time_us = time_us;
+    ring[head & (TRACE_BUFFER_SIZE - 1)].task    = task;
+    ring[head & (TRACE_BUFFER_SIZE - 1)].type    = type;
+    __sync_synchronize();   /* publish the slot before the index */
+    ring_head = head + 1;
+}
+
+static void stat_add(TraceStat_t *stat, uint32_t value, uint32_t n) {
+    if (n == 0 || value < stat->min)
+        stat->min = value;
+    if (n == 0 || value > stat->max)
+        stat->max = value;
+    stat->sum += value;
+}
+
+/* Returns the task index for a task tag, or -1 for untraced tasks. */
+static int task_index(void *tag) {
+    int id = (int) (intptr_t) tag - 1;
+    return (id >= 0 && id < n_tasks) ? id : -1;
+}
+
+static void job_start(int id, uint32_t now) {
+    TraceTask_t *t = &tasks[id];
+
+    t->state = JOB_RUNNING;
+    t->exec_us = 0;
+    t->last_in_us = now;
+    stat_add(&t->s, now - t->release_us, t->jobs);
+    put_event(id, TRACE_START, now);
+}
+
+void vTraceRegisterTask(void *xHandle, const char *name) {
+    if (n_tasks == TRACE_MAX_TASKS)
+        return;
+    tasks[n_tasks].name = name;
+    tasks[n_tasks].state = JOB_READY;
+    tasks[n_tasks].release_us = 0;
+    n_tasks++;
+    vTaskSetApplicationTaskTag((TaskHandle_t) xHandle, (TaskHookFunction_t) (intptr_t) n_tasks);
+}
+
+void vTraceHookReady(void *tag) {
+    int id = task_index(tag);
+    uint32_t now;
+
+    if (id < 0 || tasks[id].state != JOB_WAITING)
+        return;
+    now = ulTraceClockUs();
+    tasks[id].state = JOB_READY;
+    tasks[id].release_tick = tasks[id].next_release;
+    tasks[id].release_us = now;
+    put_event(id, TRACE_RELEASE, now);
+}
+
+void vTraceHookSwitchedIn(void *tag) {
+    int id = task_index(tag);
+    uint32_t now;
+
+    if (id < 0)
+        return;
+    now = ulTraceClockUs();
+    if (tasks[id].release_us == 0)
+        tasks[id].release_us = now;     /* first job starts with the scheduler */
+    if (tasks[id].state == JOB_READY) {
+        job_start(id, now);
+    } else if (tasks[id].state == JOB_PREEMPTED) {
+        tasks[id].state = JOB_RUNNING;
+        tasks[id].last_in_us = now;
+        put_event(id, TRACE_RESUME, now);
+    }
+}
+
+void vTraceHookSwitchedOut(void *tag) {
+    int id = task_index(tag);
+    uint32_t now;
+
+    if (id < 0 || tasks[id].state != JOB_RUNNING)
+        return;
+    now = ulTraceClockUs();
+    tasks[id].exec_us += now - tasks[id].last_in_us;
+    tasks[id].state = JOB_PREEMPTED;
+    tasks[id].preemptions++;
+    put_event(id, TRACE_PREEMPT, now);
+}
+
+void vTraceHookDelayUntil(void *tag, uint32_t xNextRelease) {
+    int id = task_index(tag);
+    TraceTask_t *t;
+    uint32_t now;
+    uint32_t response;
+
+    if (id < 0)
+        return;
+    t = &tasks[id];
+    taskENTER_CRITICAL();
+    if (t->state == JOB_WAITING) {
+        taskEXIT_CRITICAL();
+        return;     /* second hook of the same vTaskDelayUntil() call */
+    }
+
+    now = ulTraceClockUs();
+    t->exec_us += now - t->last_in_us;
+    response = now - t->release_us;
+    stat_add(&t->c, t->exec_us, t->jobs);
+    stat_add(&t->r, response, t->jobs);
+    t->jobs++;
+    put_event(id, TRACE_COMPLETE, now);
+
+    t->next_release = xNextRelease;
+    t->state = JOB_WAITING;
+
+    /* Overrun: the next release has already passed, so vTaskDelayUntil()
+     * returns without blocking and the next job starts right away. */
+    if ((int32_t) (xTaskGetTickCount() - xNextRelease) >= 0) {
+        t->release_us += (xNextRelease - t->release_tick) * TRACE_US_PER_TICK;
+        t->release_tick = xNextRelease;
+        put_event(id, TRACE_RELEASE, t->release_us);
+        job_start(id, now);
+    }
+    taskEXIT_CRITICAL();
+}
+
+bool xTraceRead(TraceEvent_t *pxEvent) {
+    uint32_t tail = ring_tail;
+
+    if (tail == ring_head)
+        return false;
+    __sync_synchronize();
+    *pxEvent = ring[tail & (TRACE_BUFFER_SIZE - 1)];
+    ring_tail = tail + 1;
+    return true;
+}
+
+uint32_t ulTraceDropped(void) {
+    return ring_dropped;
+}
+
+#if TRACE_EXPORT
+/* Written by the trace dump task only, from the ring */
+static TraceEvent_t capture[TRACE_EXPORT_SIZE];
+static volatile uint32_t n_captured;
+static volatile bool export_requested;
+
+static void capture_ring(void) {
+    TraceEvent_t event;
+
+    while (n_captured < TRACE_EXPORT_SIZE && xTraceRead(&event)) {
+        capture[n_captured] = event;
+        n_captured++;
+    }
+}
+
+void vTraceExportRequest(void) {
+    export_requested = true;
+}
+
+void vTraceExportJson(FILE *out) {
+    uint32_t open_us[TRACE_MAX_TASKS];
+    uint32_t jobs[TRACE_MAX_TASKS] = { 0 };
+    bool running[TRACE_MAX_TASKS] = { false };
+    uint32_t n = n_captured;
+    uint32_t t0 = n > 0 ? capture[0].time_us : 0;
+
+    fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    for (uint8_t i = 0; i < n_tasks; i++)
+        fprintf(out, "  {\"pid\": 1, \"tid\": %u, \"ph\": \"M\", \"name\": \"thread_name\", "
+                "\"args\": {\"name\": \"%s\"}},\n", i + 1, tasks[i].name);
+    for (uint32_t k = 0; k < n; k++) {
+        const TraceEvent_t *e = &capture[k];
+        uint32_t ts = e->time_us - t0;
+
+        switch (e->type) {
+        case TRACE_RELEASE:
+            fprintf(out, "  {\"pid\": 1, \"tid\": %u, \"ph\": \"i\", \"s\": \"t\", "
+                    "\"name\": \"release\", \"ts\": %lu},\n", e->task + 1, (unsigned long) ts);
+            break;
+        case TRACE_START:
+            jobs[e->task]++;
+            /* fall through */
+        case TRACE_RESUME:
+            open_us[e->task] = ts;
+            running[e->task] = true;
+            break;
+        default:
+            // Preempt or complete: one slice per stretch of execution.
+            // A task already running when the capture began has none.
+            if (running[e->task])
+                fprintf(out, "  {\"pid\": 1, \"tid\": %u, \"ph\": \"X\", \"name\": \"job %lu\", "
+                        "\"ts\": %lu, \"dur\": %lu},\n", e->task + 1, (unsigned long) jobs[e->task],
+                        (unsigned long) open_us[e->task], (unsigned long) (ts - open_us[e->task]));
+            running[e->task] = false;
+            break;
+        }
+    }
+    // Last element, without a trailing comma
+    fprintf(out, "  {\"pid\": 1, \"ph\": \"M\", \"name\": \"process_name\", "
+            "\"args\": {\"name\": \"lab2 cruise control\"}}\n");
+    fprintf(out, "], \"otherData\": {\"dropped\": %lu}}\n", (unsigned long) ring_dropped);
+}
+
+/* Host build: to the file SIM_TRACE (default trace.json). On the Lab-Kit
+ * the JSON goes to the console between two marker lines. */
+static void export_now(void) {
+#ifdef SIM_TICKS_PER_WALL_MS
+    const char *path = getenv("SIM_TRACE");
+    FILE *f;
+
+    if (path == NULL)
+        path = "trace.json";
+    if ((f = fopen(path, "w")) == NULL) {
+        perror(path);
+        return;
+    }
+    vTraceExportJson(f);
+    fclose(f);
+    printf("--- JOB TRACE: %lu events written to %s ---\n", (unsigned long) n_captured, path);
+#else
+    printf("--- TRACE JSON BEGIN ---\n");
+    vTraceExportJson(stdout);
+    printf("--- TRACE JSON END ---\n");
+#endif
+}
+
+#ifdef SIM_TICKS_PER_WALL_MS
+/* The simulation ends with exit() from the SIM task (SIM_RUN_MS,
+ * SIM_LAPS); the other tasks are stopped by then. */
+static void export_at_exit(void) {
+    capture_ring();
+    export_now();
+}
+#endif
+#endif
+
+/* Prints a time in seconds with the same resolution as the Ada reports. */
+static void print_s(const char *label, uint32_t us) {
+    printf("%s%lu.%06lu", label, (unsigned long) (us / 1000000), (unsigned long) (us % 1000000));
+}
+
+void vTraceDumpStats(void) {
+    TraceTask_t snap[TRACE_MAX_TASKS];
+    uint8_t n;
+
+    taskENTER_CRITICAL();
+    n = n_tasks;
+    for (uint8_t i = 0; i < n; i++)
+        snap[i] = tasks[i];
+    taskEXIT_CRITICAL();
+
+    printf("--- JOB TRACE (%lu events dropped) ---\n", (unsigned long) ring_dropped);
+    for (uint8_t i = 0; i < n; i++) {
+        TraceTask_t *t = &snap[i];
+        uint32_t jobs = t->jobs ? t->jobs : 1;
+
+        printf("Task %s - jobs: %lu, preemptions: %lu\n", t->name,
+               (unsigned long) t->jobs, (unsigned long) t->preemptions);
+        print_s("  C min: ", t->c.min);
+        print_s(", avg: ", (uint32_t) (t->c.sum / jobs));
+        print_s(", WCET: ", t->c.max);
+        print_s("\n  R min: ", t->r.min);
+        print_s(", avg: ", (uint32_t) (t->r.sum / jobs));
+        print_s(", WCRT: ", t->r.max);
+        print_s("\n  Jitter min: ", t->s.min);
+        print_s(", avg: ", (uint32_t) (t->s.sum / jobs));
+        print_s(", max: ", t->s.max);
+        printf("\n");
+    }
+}
+
+void vTraceDumpTask(void *args) {
+    TickType_t xLastWakeTime = 0;
+    const TickType_t xPeriod = (uint32_t) args;
+    TraceEvent_t event;
+#if TRACE_EXPORT
+    TickType_t xNextDump = 0;
+    bool exported = false;
+
+#ifdef SIM_TICKS_PER_WALL_MS
+    atexit(export_at_exit);
+#endif
+    while(true) {
+        // Copy the ring into the capture buffer; no I/O until it is
+        // full or an export is asked for.
+        capture_ring();
+        if (export_requested || (n_captured == TRACE_EXPORT_SIZE && !exported)) {
+            export_now();
+            export_requested = false;
+            exported = n_captured == TRACE_EXPORT_SIZE;
+        }
+        // Once the capture is full the ring is only emptied
+        while (xTraceRead(&event))
+            ;
+        if ((int32_t) (xLastWakeTime - xNextDump) >= 0) {
+            vTraceDumpStats();
+            xNextDump += xPeriod;
+        }
+        vTaskDelayUntil(&xLastWakeTime, TRACE_DRAIN_PERIOD);
+    }
+#else
+    while(true) {
+        // Keep the ring from filling up, the per-task statistics
+        // are already kept by the hooks.
+        while (xTraceRead(&event))
+            ;
+        vTraceDumpStats();
+        vTaskDelayUntil(&xLastWakeTime, xPeriod);
+    }
+#endif
+}
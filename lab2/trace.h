@@ -0,0 +1,107 @@
+/**
+ * @file trace.h
+ * @brief Per-job timing trace for the lab2 periodic tasks.
+ *
+ *        Release, start, preemption and completion of every job of a
+ *        registered task are recorded from the FreeRTOS trace hooks
+ *        into a lock-free ring buffer, and folded into per-task
+ *        execution time (C), response time (R) and start-latency
+ *        (jitter) statistics.
+ *
+ *        With TRACE_EXPORT = 1 the trace dump task also copies the
+ *        events into a preallocated capture buffer and writes them as a
+ *        Chrome trace-event JSON file (Perfetto, chrome://tracing), the
+ *        same layout as Write_Trace of lab1B/common/workload: one track
+ *        per task, a slice per stretch of execution, an instant per
+ *        release. The JSON is written when the buffer is full, on
+ *        vTraceExportRequest() and, in the host build, when the
+ *        simulation exits, never from the hooks.
+ *
+ *        Enable with configUSE_JOB_TRACE = 1. The hook macros at the
+ *        end of this file must be seen by tasks.c, so include this
+ *        header at the end of FreeRTOSConfig.h (sim/FreeRTOSConfig.h
+ *        already does). configUSE_APPLICATION_TASK_TAG must be 1.
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#ifndef configUSE_JOB_TRACE
+#define configUSE_JOB_TRACE 0
+#endif
+
+#define TRACE_MAX_TASKS     8
+#define TRACE_BUFFER_SIZE   512     /* events, must be a power of 2 */
+#define TRACE_DUMP_PERIOD   10000   /* ms between two statistics dumps */
+
+#ifndef TRACE_EXPORT
+#define TRACE_EXPORT        0
+#endif
+#define TRACE_EXPORT_SIZE   4096    /* events kept for the JSON export */
+#define TRACE_DRAIN_PERIOD  100     /* ms between two copies of the ring */
+
+typedef enum {
+    TRACE_RELEASE = 0,
+    TRACE_START,
+    TRACE_PREEMPT,
+    TRACE_RESUME,
+    TRACE_COMPLETE
+} TraceEventType_t;
+
+typedef struct {
+    uint32_t time_us;
+    uint8_t  task;      /* index given by vTraceRegisterTask() */
+    uint8_t  type;      /* TraceEventType_t */
+} TraceEvent_t;
+
+/* Start tracing a task. Call after xTaskCreate, before the scheduler starts. */
+void vTraceRegisterTask(void *xHandle, const char *name);
+
+/* Consumer side of the ring buffer. Returns false if it is empty. */
+bool xTraceRead(TraceEvent_t *pxEvent);
+uint32_t ulTraceDropped(void);
+
+/* Prints min/avg/max C, R and start latency for every registered task. */
+void vTraceDumpStats(void);
+
+/* Lowest priority task that calls vTraceDumpStats() every TRACE_DUMP_PERIOD. */
+void vTraceDumpTask(void *args);
+
+uint32_t ulTraceClockUs(void);
+
+/* Asks the trace dump task to write the captured events at its next
+ * wake-up (TRACE_EXPORT). */
+void vTraceExportRequest(void);
+
+/* Writes the captured events as Chrome trace-event JSON. Only the trace
+ * dump task adds to the capture buffer: call it from there, or at exit. */
+void vTraceExportJson(FILE *out);
+
+/* Called from the kernel hooks below, not by the application. */
+void vTraceHookReady(void *tag);
+void vTraceHookSwitchedIn(void *tag);
+void vTraceHookSwitchedOut(void *tag);
+void vTraceHookDelayUntil(void *tag, uint32_t xNextRelease);
+
+#if configUSE_JOB_TRACE
+#define traceMOVED_TASK_TO_READY_STATE( pxTCB ) \
+    vTraceHookReady( ( void * ) ( pxTCB )->pxTaskTag )
+#define traceTASK_SWITCHED_IN() \
+    vTraceHookSwitchedIn( ( void * ) pxCurrentTCB->pxTaskTag )
+#define traceTASK_SWITCHED_OUT() \
+    vTraceHookSwitchedOut( ( void * ) pxCurrentTCB->pxTaskTag )
+/* Kernel V11 reports every call, also when the release already passed.
+ * V10 only has traceTASK_DELAY_UNTIL, which is skipped on an overrun.
+ * The V11 hook runs in task context with interrupts enabled, so
+ * vTraceHookDelayUntil() enters a critical section itself. */
+#define traceENTER_xTaskDelayUntil( pxPreviousWakeTime, xTimeIncrement ) \
+    vTraceHookDelayUntil( ( void * ) pxCurrentTCB->pxTaskTag, \
+                          ( uint32_t ) ( *( pxPreviousWakeTime ) + ( xTimeIncrement ) ) )
+#define traceTASK_DELAY_UNTIL( xTimeToWake ) \
+    vTraceHookDelayUntil( ( void * ) pxCurrentTCB->pxTaskTag, ( uint32_t ) ( xTimeToWake ) )
+#endif
+
+#endif /* TRACE_H */
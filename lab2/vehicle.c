@@ -0,0 +1,129 @@
+/**
+ * @file vehicle.c
+ * @brief Plant model of the cruise control: position, velocity and
+ *        the terrain and wind retardation used by vVehicleTask.
+ *        Plain C without FreeRTOS, so that host tools can run the
+ *        same model as the target.
+ */
+#include "vehicle.h"
+
+/**
+ * @brief The function returns the new position depending on the input parameters.
+ * 
+ * ==> DO NOT CHANGE THIS FUNCTION !!!
+ * 
+ * @param position 
+ * @param velocity 
+ * @param acceleration 
+ * @param time_interval 
+ * @return 
+ */
+uint16_t adjust_position(uint16_t position, int16_t velocity,
+                         int8_t acceleration, uint16_t time_interval)
+{
+  int16_t new_position = position + velocity * time_interval / 1000
+    + acceleration / 2  * (time_interval / 1000) * (time_interval / 1000);
+
+  if (new_position > 24000) {
+    new_position -= 24000;
+  } else if (new_position < 0){
+    new_position += 24000;
+  }
+
+  return new_position;
+}
+
+
+/**
+ * @brief The function returns the new velocity depending on the input parameters.
+ * 
+ * ==> DO NOT CHANGE THIS FUNCTION !!! 
+ *
+ * @param velocity 
+ * @param acceleration 
+ * @param brake_pedal 
+ * @param time_interval 
+ * @return 
+ */
+int16_t adjust_velocity(int16_t velocity, int8_t acceleration,  
+		       bool brake_pedal, uint16_t time_interval)
+{
+  int16_t new_velocity;
+  uint8_t brake_retardation = 50;
+
+  if (brake_pedal == false) {
+    // Had to manually change here because it was casted to float after division...
+    new_velocity = velocity  + ((float) (acceleration * time_interval) / 1000);
+    //printf("nv: %d, v: %d, a: %d, time_int: %d\n", new_velocity, velocity, acceleration, time_interval);
+    if (new_velocity <= 0) {
+        new_velocity = 0;
+    }
+  } 
+  else { 
+    if ((float) (brake_retardation * time_interval) / 1000 > velocity) {
+       new_velocity = 0;
+    }
+    else {
+      new_velocity = velocity - (float) brake_retardation * time_interval / 1000;
+    }
+  } 
+
+  return new_velocity;
+}
+
+/**
+ * @brief Extra retardation of the terrain segment at position:
+ *        even, uphill, steep uphill, even, downhill, steep downhill.
+ */
+int8_t terrain_retardation(uint16_t position)
+{
+  if (position < 4000)
+    return 0;   // even ground
+  else if (position < 8000)
+    return 8;   // traveling uphill
+  else if (position < 12000)
+    return 16;  // traveling steep uphill
+  else if (position < 16000)
+    return 0;   // even ground
+  else if (position < 20000)
+    return -8;  // traveling downhill
+  else
+    return -16; // traveling steep downhill
+}
+
+/**
+ * @brief Wind retardation at the current velocity.
+ */
+int16_t wind_retardation(uint16_t velocity)
+{
+  uint16_t wind_factor;  /* Value between -10 and 20 (2.0 m/s^2 and -1.0 m/s^2) */
+
+  if (velocity > 0)
+    wind_factor = velocity * velocity / 10000 + 1;
+  else 
+    wind_factor = (-1) * velocity * velocity / 10000 + 1;
+
+  return wind_factor;
+}
+
+/**
+ * @brief Wind and terrain retardation at the current position and velocity.
+ */
+int16_t vehicle_retardation(uint16_t position, uint16_t velocity)
+{
+  return wind_retardation(velocity) + terrain_retardation(position);
+}
+
+/**
+ * @brief Acceleration for the throttle at the current position and velocity,
+ *        as computed by vVehicleTask.
+ */
+int8_t vehicle_acceleration(uint16_t throttle, uint16_t position, uint16_t velocity)
+{
+  uint8_t retardation;   /* Value between 20 and -10 (2.0 m/s^2 and -1.0 m/s^2) */
+
+  /* Retardation : Factor of Terrain and Wind Resistance */
+  retardation = vehicle_retardation(position, velocity);
+
+  return throttle / 2 - retardation;
+}
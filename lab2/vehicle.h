@@ -0,0 +1,23 @@
+/**
+ * @file vehicle.h
+ * @brief Plant model of the cruise control, see vehicle.c.
+ */
+#ifndef VEHICLE_H
+#define VEHICLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define VEHICLE_LAP         24000   /* position units of one lap */
+
+uint16_t adjust_position(uint16_t position, int16_t velocity,
+                         int8_t acceleration, uint16_t time_interval);
+int16_t adjust_velocity(int16_t velocity, int8_t acceleration,
+                        bool brake_pedal, uint16_t time_interval);
+
+int8_t terrain_retardation(uint16_t position);
+int16_t wind_retardation(uint16_t velocity);
+int16_t vehicle_retardation(uint16_t position, uint16_t velocity);
+int8_t vehicle_acceleration(uint16_t throttle, uint16_t position, uint16_t velocity);
+
+#endif /* VEHICLE_H */